@@ -1,8 +1,21 @@
+#define _POSIX_C_SOURCE 200809L // fileno, needed for mmap of binary traces
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
-#include <ctype.h>
+#include <limits.h>
+#include <time.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#define TRACE_USE_MMAP 1 // binary traces are mapped into memory instead of read
+#endif
+#include "scheduler.h"
+#include "sweep.h"
+#include "report.h"
+#include "workload.h"
+#include "reference.h"
 
 /*
 Process / File scheduler implements round robin (RR) with dynamic time quantums & shortest job first approach (SJF).
@@ -21,620 +34,1950 @@ If a new process enters queue and more than 1 process in queue.
         >> i.e., file with lowest arrival time will be processed instead. 
 */
 
-int ITEMS_IN_QUEUE = 0;
-int DEFAULT_TIME_QUANTUM = 5; // arbritary default value
-int TIME_ELAPSED = 0;
-char line[100];
-
-typedef struct fileAttribute
-{
-    int arrivalTime; // time process enters ready state
-    int burstTime;   // time required for process
-    int waitingTime; // total time process is in ready state
-    int turnAroundTime; // time till completion since arrival
-    int backUpBurstTime; // when 0, process is deemed to have completed
-    int timeAddedToQueue; // time process gets added into queue (SHould be same as arrival time)
-    int fileID;           // corresponds to index it is stored in
-    int responseTime;     // time process gets passed to CPU
-    int timeStopped;
-
-    bool hasArrived;   // if time-elapsed, file/proceess deemed to have arrived
-    bool hasCompleted; // ignore once completed
-    bool inQueue;      // if its in the ready queue
-    bool processing;   // if it is currently being processed
-    bool saved;        // bool to check if time that process changes is saved
-    bool calculated;   // bool to check if waiting time has been calculated
-    bool startedButNotComp; // process requeued, started but not completed
-} fileAttribute;
-// Struct that stores basic file attributes, increases modularity and allows other aspects of file to be stored
-// e.g., priority, type, group etc.
-
-typedef struct readyQueueNode
-{
-    // ready queue implemented as a linked list 
-    fileAttribute file;
-    struct readyQueueNode *next;
-} readyQueueNode;
-
-int getNumberOfFiles(FILE *fp);
-void printFileTable(fileAttribute fileTable[], int numberOfFiles);
-void populateQueueIfArrive(int numberOfFiles, fileAttribute fileTable[], readyQueueNode *readyQueue);
-void AddToReadyQueue(fileAttribute fileTableEntry, readyQueueNode *readyQueue);
-void printReadyQueueEntries(readyQueueNode *readyQueue);
-void HybridRoundRobin(int TIME_QUANTUM, readyQueueNode *readyQueue, fileAttribute fileTable[], fileAttribute completedFileTable[], int numberOfFiles, int *processCompleted, int *completedIndex);
-void UpdateWaitingTimes(readyQueueNode *readyQueue);
-int getLowestRemainingBurstTime(readyQueueNode *readyQueue);
-int CountUncompletedProcessesInQueue(readyQueueNode *readyQueue);
-int validate(char* value);
-float GetAverageTurnaroundTime(fileAttribute completedFileTable[], int numberOfFiles);
-float GetAverageWaitingTime(fileAttribute completedFileTable[], int numberOfFiles);
-float GetMinWaitingTime(fileAttribute completedFileTable[], int numberOfFiles);
-float GetMaxWaitingTime(fileAttribute completedFileTable[], int numberOfFiles);
-float GetMinTurnAroundTime(fileAttribute completedFileTable[], int numberOfFiles);
-float GetMaxTurnAroundTime(fileAttribute completedFileTable[], int numberOfFiles);
-void printOrderOfCompletion(fileAttribute completedFileTable[], int numberOfFiles);
-void freeAllocatedMemory(readyQueueNode *readyQueue);
+#define TRACE_INITIAL_CAPACITY 1024     // rows allocated before the trace columns first have to grow
+#define TRACE_READ_BLOCK_SIZE (1 << 20) // bytes read from the trace file at once
+#define ONLINE_READ_LINE_SIZE 4096      // bytes read from a live trace at once, at most one line
+#define BINARY_TRACE_MAGIC "HRRB"       // first bytes of a binary trace, text traces start with a digit
+#define BINARY_TRACE_VERSION 1
+#define BINARY_TRACE_HEADER_SIZE 16
+#define BENCHMARK_MIN_JOBS 100          // smallest workload benchmarked, sizes grow 10x from here
+#define BENCHMARK_MAX_JOBS 10000000     // largest workload benchmarked unless --max-jobs is given
+#define DIFFERENTIAL_RUNS 1000          // random traces checked against the reference unless --runs is given
+#define DIFFERENTIAL_MAX_JOBS 40        // most processes in a random trace unless --max-jobs is given
+#define GOLDEN_FIELDS 7                 // id, arrival, burst, completion, wait, turnaround, response
+#define TRACE_MAX_GROUPS 4096           // groups numbered 0 to TRACE_MAX_GROUPS - 1 in a trace
+
+/*
+Binary trace format (version 1), every field little-endian:
+>> char    magic[4]       "HRRB"
+>> uint32  version        1
+>> uint64  count          number of processes
+>> int32   arrival[count] arrival time column
+>> int32   burst[count]   burst time column
+Columns start 16 bytes in, so on little-endian hosts they are used in place from the mapped file.
+Convert with --to-binary / --to-text, the simulator detects which format it is given.
+*/
+
+typedef struct traceColumns
+{
+    // Arrival and burst time of every process in trace order, handed to the scheduler without copying
+    int count;
+    int capacity;
+    int *arrivalTime;
+    int *burstTime;
+    int *priority;       // optional third column, NULL while no line has given one
+    int *group;          // optional fourth column, NULL while no line has given one
+    int groupCount;      // highest group + 1
+
+    void *mappedTrace;   // binary trace mapped into memory, arrivalTime and burstTime point into it
+    size_t mappedLength;
+} traceColumns;
+
+typedef struct traceParser
+{
+    // State carried from one block of the trace to the next, so a line may straddle two reads
+    int lineNumber;
+    int field;       // 0 == arrival time, 1 == burst time, 2 == priority, 3 == group, further tokens are ignored
+    bool inToken;
+    bool finished;   // empty line reached, anything after it is not part of the input
+    long long value; // digits of the current token converted so far
+    int values[4];   // arrival time, burst time, priority and group of the current line
+    traceColumns *trace; // batch mode, lines are appended here
+    scheduler *online;   // online mode, lines are added to the running scheduler instead
+} traceParser;
+
+typedef struct timelineWriter
+{
+    // Gantt chart as dispatch intervals, back to back time slices of a process on one CPU are merged into one
+    // Written as a timeline (--timeline), as a chrome://tracing / Perfetto trace (--trace-events) or both
+    reportWriter writer;
+    reportWriter events;
+    bool toTimeline;
+    bool toEvents;
+    schedulerTimeSlice *open; // interval still growing on each CPU, process == -1 while there is none
+    int cpuCount;
+} timelineWriter;
+
+void *allocateColumn(size_t count, size_t size);
+void initTraceColumns(traceColumns *trace);
+void appendTraceRow(traceColumns *trace, int arrivalTime, int burstTime, int priority, int group);
+void freeTraceColumns(traceColumns *trace);
+int readTraceFile(FILE *fp, traceColumns *trace);
+int parseTraceFile(FILE *fp, traceParser *parser);
+void initTraceParser(traceParser *parser);
+void feedTraceParser(traceParser *parser, const char *block, size_t length);
+void endTraceToken(traceParser *parser);
+void endTraceLine(traceParser *parser);
+bool hostIsLittleEndian(void);
+unsigned int decodeUInt32(const unsigned char *bytes);
+void encodeUInt32(unsigned char *bytes, unsigned int value);
+int loadBinaryTrace(FILE *fp, traceColumns *trace);
+void writeBinaryTrace(FILE *fp, traceColumns *trace);
+void writeTextTrace(FILE *fp, traceColumns *trace);
+void convertTraceFile(const char *mode, const char *inputPath, const char *outputPath);
+void exitOnSchedulerError(schedulerStatus status);
+void runOnlineSimulation(FILE *fp, int TIME_QUANTUM);
+void runParameterSweep(int argc, char *argv[]);
+void runBenchmark(int argc, char *argv[]);
+double elapsedSeconds(const struct timespec *start, const struct timespec *end);
+void runGoldenCheck(int argc, char *argv[]);
+bool checkGolden(const char *tracePath);
+void goldenPathFor(const char *tracePath, char *goldenPath, size_t size);
+void runDifferentialCheck(int argc, char *argv[]);
+bool findMismatch(const int *arrivalTime, const int *burstTime, int count, int timeQuantum, char *detail, size_t size);
+void shrinkTrace(int *arrivalTime, int *burstTime, int *count, int timeQuantum);
+bool shrinkValue(int *value, int lowest, const int *arrivalTime, const int *burstTime, int count, int timeQuantum);
+void runPolicyComparison(const char *path, int switchCost);
+void saveSnapshotAt(scheduler *s, int time, const char *path);
+void runRestoredSimulation(const char *snapshotPath, const char *tracePath);
+int parseIntegerList(const char *list, int minimum, const char *what, int **values);
+int parsePolicyList(const char *list, schedulerPolicy **policies);
+int parseWeightList(const char *list, int **weights);
+bool readOnlineTrace(FILE *fp, traceParser *parser);
+void printCompletion(void *context, const schedulerCompletion *completion);
+FILE *createOutputFile(const char *path);
+void closeReport(reportWriter *writer, FILE *fp, const char *path);
+void writeJobRecords(scheduler *s, const char *path);
+void openTimeline(timelineWriter *timeline, const char *path, const char *eventsPath, int cpuCount);
+void writeTimeSlice(void *context, const schedulerTimeSlice *slice);
+void writeTimelineInterval(timelineWriter *timeline, const schedulerTimeSlice *interval);
+void closeTimeline(timelineWriter *timeline, const char *path, const char *eventsPath);
+void writeTraceEvent(reportWriter *writer, const char *name, int id, int pid, int tid, long long start, long long duration, long long nodesVisited);
+void writeTraceMetadata(reportWriter *writer, const char *kind, int pid, int tid, const char *name, int id);
+void writeMicroseconds(reportWriter *writer, long long nanoseconds);
+void printResults(schedulerResults *results);
+void printOrderOfCompletion(scheduler *s);
+void printPercentiles(scheduler *s);
+void printContextSwitches(schedulerResults *results);
+void printCpuStats(scheduler *s);
+void printClassStats(scheduler *s);
+void printProfile(void);
 
 int main(int argc, char* argv[])
 {
-    if (argc != 2) {
+    if (argc == 4 && (strcmp(argv[1], "--to-binary") == 0 || strcmp(argv[1], "--to-text") == 0))
+    {
+        convertTraceFile(argv[1], argv[2], argv[3]);
+        exit(0);
+    }
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "--online") == 0)
+    {
+        // Live trace from a pipe, FIFO or file, stdin when no file is given
+        FILE *stream = argc == 3 ? fopen(argv[2], "rb") : stdin;
+        if (stream == NULL)
+        {
+            printf("<%s> does not exist!\n", argv[2]);
+            exit(1);
+        }
+        runOnlineSimulation(stream, DEFAULT_TIME_QUANTUM);
+        exit(0);
+    }
+    if (argc == 3 && strcmp(argv[1], "--compare") == 0)
+    {
+        runPolicyComparison(argv[2], 0);
+        exit(0);
+    }
+    if (argc == 5 && strcmp(argv[1], "--compare") == 0 && strcmp(argv[2], "--switch-cost") == 0 && atoi(argv[3]) >= 0)
+    {
+        runPolicyComparison(argv[4], atoi(argv[3]));
+        exit(0);
+    }
+    if (argc >= 4 && strcmp(argv[1], "--sweep") == 0)
+    {
+        runParameterSweep(argc, argv);
+        exit(0);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--benchmark") == 0)
+    {
+        runBenchmark(argc, argv);
+        exit(0);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--check") == 0)
+    {
+        runGoldenCheck(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--differential") == 0)
+    {
+        runDifferentialCheck(argc, argv);
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--restore") == 0)
+    {
+        runRestoredSimulation(argv[2], argc == 4 ? argv[3] : NULL);
+        exit(0);
+    }
+    // Batch mode, optionally on several CPUs and with a context switch cost
+    // --percentiles, --cpus and --switch-cost add the percentile, CPU and context switch report after the order of completion
+    // --jobs and --timeline write per-process records and dispatch intervals to a file, JSON if it ends in .json, CSV otherwise
+    // --fair-share schedules by the priority and group columns, --weights and --aging tune it
+    // --snapshot saves the state at the first event from --snapshot-at (0 unless given) for --restore
+    // --profile prints the time spent per engine phase, --trace-events writes the schedule and the phases as a chrome trace
+    int CPU_COUNT = 1;
+    int SWITCH_COST = 0;
+    bool EXTENDED_REPORT = false;
+    const char *JOBS_PATH = NULL;
+    const char *TIMELINE_PATH = NULL;
+    const char *EVENTS_PATH = NULL;
+    bool PROFILE = false;
+    bool FAIR_SHARE = false;
+    int *GROUP_WEIGHTS = NULL;
+    int WEIGHT_COUNT = 0;
+    int AGING_INTERVAL = DEFAULT_AGING_INTERVAL;
+    const char *SNAPSHOT_PATH = NULL;
+    int SNAPSHOT_TIME = 0;
+    int arg = 1;
+    bool validOption = true;
+    while (arg < argc - 1 && validOption)
+    {
+        if (strcmp(argv[arg], "--percentiles") == 0)
+        {
+            EXTENDED_REPORT = true;
+            arg++;
+            continue;
+        }
+        if (strcmp(argv[arg], "--fair-share") == 0)
+        {
+            FAIR_SHARE = true;
+            arg++;
+            continue;
+        }
+        if (strcmp(argv[arg], "--profile") == 0)
+        {
+            PROFILE = true;
+            arg++;
+            continue;
+        }
+        if (strcmp(argv[arg], "--cpus") == 0 && arg + 2 < argc)
+        {
+            CPU_COUNT = atoi(argv[arg + 1]);
+            validOption = CPU_COUNT >= 1;
+            EXTENDED_REPORT = true;
+        }
+        else if (strcmp(argv[arg], "--switch-cost") == 0 && arg + 2 < argc)
+        {
+            SWITCH_COST = atoi(argv[arg + 1]);
+            validOption = SWITCH_COST >= 0;
+            EXTENDED_REPORT = true;
+        }
+        else if (strcmp(argv[arg], "--jobs") == 0 && arg + 2 < argc)
+        {
+            JOBS_PATH = argv[arg + 1];
+        }
+        else if (strcmp(argv[arg], "--timeline") == 0 && arg + 2 < argc)
+        {
+            TIMELINE_PATH = argv[arg + 1];
+        }
+        else if (strcmp(argv[arg], "--trace-events") == 0 && arg + 2 < argc)
+        {
+            EVENTS_PATH = argv[arg + 1];
+        }
+        else if (strcmp(argv[arg], "--weights") == 0 && arg + 2 < argc && GROUP_WEIGHTS == NULL)
+        {
+            WEIGHT_COUNT = parseWeightList(argv[arg + 1], &GROUP_WEIGHTS);
+        }
+        else if (strcmp(argv[arg], "--aging") == 0 && arg + 2 < argc)
+        {
+            AGING_INTERVAL = atoi(argv[arg + 1]);
+            validOption = AGING_INTERVAL >= 0;
+        }
+        else if (strcmp(argv[arg], "--snapshot") == 0 && arg + 2 < argc)
+        {
+            SNAPSHOT_PATH = argv[arg + 1];
+        }
+        else if (strcmp(argv[arg], "--snapshot-at") == 0 && arg + 2 < argc)
+        {
+            SNAPSHOT_TIME = atoi(argv[arg + 1]);
+            validOption = SNAPSHOT_TIME >= 0;
+        }
+        else
+        {
+            validOption = false;
+        }
+        arg += 2;
+    }
+    if (!validOption || arg != argc - 1) {
         printf("Invalid usage: <./assignment> <filename.txt>\n");
+        printf("               <./assignment> [--percentiles] [--cpus <count>] [--switch-cost <time>] <filename.txt>\n");
+        printf("               <./assignment> [--jobs <jobs.csv|jobs.json>] [--timeline <timeline.csv|timeline.json>] <filename.txt>\n");
+        printf("               <./assignment> [--fair-share] [--weights <w0,w1,...>] [--aging <time>] <filename.txt>\n");
+        printf("               <./assignment> [--snapshot <state.snap>] [--snapshot-at <time>] <filename.txt>\n");
+        printf("               <./assignment> [--profile] [--trace-events <trace.json>] <filename.txt>\n");
+        printf("               <./assignment> --restore <state.snap> [filename.txt]\n");
+        printf("               <./assignment> --online [filename.txt]\n");
+        printf("               <./assignment> --compare [--switch-cost <time>] <filename.txt>\n");
+        printf("               <./assignment> --sweep [-j threads] [--policies <hybrid,rr,...|all>] [--cpus <counts>] [--switch-cost <times>]\n");
+        printf("                              <quanta, e.g. 1-64 or 2,5,10> <filename.txt>...\n");
+        printf("               <./assignment> --benchmark [--seed <n>] [--max-jobs <n>] [uniform|poisson|bimodal|pareto|bursty]...\n");
+        printf("               <./assignment> --check <filename.txt>...\n");
+        printf("               <./assignment> --differential [--seed <n>] [--runs <n>] [--max-jobs <n>]\n");
+        printf("               <./assignment> --to-binary <filename.txt> <filename.bin>\n");
+        printf("               <./assignment> --to-text <filename.bin> <filename.txt>\n");
         exit(1);
     }
 
-    FILE *fp = fopen(argv[1], "r");
+    const char *path = argv[arg];
+    FILE *fp = fopen(path, "rb");
     if (fp == NULL)
     {
-        printf("<%s> does not exist!\n", argv[1]);
+        printf("<%s> does not exist!\n", path);
         exit(1);
     }
 
     int TIME_QUANTUM = DEFAULT_TIME_QUANTUM; // Intial time_quantum == Default time quantum (5)
-    int numberOfFiles = 0;
-
-    // Obtains number of files and creates an array to store their file attributes
-    numberOfFiles = getNumberOfFiles(fp);
-    fileAttribute fileTable[numberOfFiles];
-    fileAttribute completedFileTable[numberOfFiles];
-    int completedIndex = 0; // maintains order in which processes were completed
 
-    // Initially create a ready linked list that can contain 1 node, each node contains a fileTable entry and next
-    readyQueueNode *readyQueue = malloc(sizeof(readyQueueNode));
-   
-    int processesInQueue = 0;
+    // Parses the text or binary trace in a single pass into arrival and burst time columns
+    traceColumns trace;
+    initTraceColumns(&trace);
+    readTraceFile(fp, &trace);
+    fclose(fp);
 
-    if (readyQueue == NULL)
+    // The scheduler uses the parsed columns in place and keeps every completion for the order of completion
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    options.timeQuantum = TIME_QUANTUM;
+    options.cpuCount = CPU_COUNT;
+    options.switchCost = SWITCH_COST;
+    options.retainCompletions = true;
+    options.groupCount = trace.groupCount > WEIGHT_COUNT ? trace.groupCount : WEIGHT_COUNT;
+    options.agingInterval = AGING_INTERVAL;
+    if (FAIR_SHARE)
+    {
+        options.policy = SCHEDULER_POLICY_FAIR_SHARE;
+    }
+    if (GROUP_WEIGHTS != NULL && WEIGHT_COUNT < options.groupCount)
+    {
+        printf("Expected a weight for each of the %i groups\n", options.groupCount);
+        exit(1);
+    }
+    options.groupWeights = GROUP_WEIGHTS;
+    timelineWriter timeline;
+    if (TIMELINE_PATH != NULL || EVENTS_PATH != NULL)
+    {
+        openTimeline(&timeline, TIMELINE_PATH, EVENTS_PATH, CPU_COUNT);
+        options.onTimeSlice = writeTimeSlice;
+        options.callbackContext = &timeline;
+    }
+    scheduler *s = SchedulerCreate(&options);
+    if (s == NULL)
     {
         printf("Failed to allocate memory\n");
         exit(1);
     }
-
-    // Initializing file table contents 
-    // fileTable[i] stores parsed data from text file e.g., burst  + waiting time
-    // completedFileTable[i] stores computed burst, waiting, turnaround times. 
-    for (int i = 0; i < numberOfFiles; i++)
+    exitOnSchedulerError(SchedulerAddJobClassColumns(s, trace.arrivalTime, trace.burstTime, trace.priority, trace.group, trace.count));
+    SchedulerResetProfile(EVENTS_PATH != NULL);
+    if (SNAPSHOT_PATH != NULL)
     {
-        fileTable[i].arrivalTime = -1;
-        fileTable[i].burstTime = -1;
-        fileTable[i].waitingTime = 0;
-        fileTable[i].turnAroundTime = 0;
-        fileTable[i].backUpBurstTime = -1;
-        fileTable[i].fileID = i; // fileID also == index it is stored within fileTable[]
-        fileTable[i].timeAddedToQueue = 0;
-        fileTable[i].responseTime = -1;
-        fileTable[i].timeStopped = 0;
-
-        fileTable[i].hasArrived = false;
-        fileTable[i].hasCompleted = false;
-        fileTable[i].inQueue = false;
-        fileTable[i].processing = false;
-        fileTable[i].saved = false;
-        fileTable[i].calculated = true;
-        fileTable[i].startedButNotComp = false;
-
-        completedFileTable[i].arrivalTime = -1;
-        completedFileTable[i].burstTime = -1;
-        completedFileTable[i].waitingTime = 0;
-        completedFileTable[i].turnAroundTime = 0;
-        completedFileTable[i].backUpBurstTime = -1;
-        completedFileTable[i].fileID = i; 
-        completedFileTable[i].timeAddedToQueue = 0;
-        completedFileTable[i].responseTime = -1;
-
-        completedFileTable[i].hasArrived = false;
-        completedFileTable[i].hasCompleted = false;
-        completedFileTable[i].inQueue = false;
-        completedFileTable[i].processing = false;
-    }
-
-    // Obtain arrival and burst time from text file
-    int i = 0, j = 0, k = 0, counter = 0;
-    int bufferLength = 255;
-    char buffer[255];//buffer to hold file input
-    while(fgets(buffer, bufferLength, fp)) { //retrieve file input line by line
-        int v = 0;
-        char line[6];
-        char *ptr = strtok(buffer, " \t");
-        while (v<2)
-        {
-            strcpy(line,ptr); //copy string from input to line
-            char *newptr = line;
-            newptr[strcspn(newptr, "\n")] = 0; //remove newline \n from input
-            int check = validate(newptr); //ensure only positive integer values
-            if(check == 0){
-                printf("Invalid input detected at line %d \n",counter+1);
-                exit(0);
-            }
-            if(v==0){
-                int j = (int)strtol(newptr, (char **)NULL, 10);
-                fileTable[i].arrivalTime = j; //store arrival time
-            }else if(v==1){
-                int k = (int)strtol(newptr, (char **)NULL, 10);
-                fileTable[i].burstTime = k;
-                fileTable[i].backUpBurstTime = k; //store burst time
-            }
-            ptr = strtok(NULL, " \t"); //move to next value in line
-            v++;
-        }
-        i++;
-        counter++;
-        if(counter == numberOfFiles){ //to ensure we do not accept inputs after newline encountered
-                break;
-            }
-        }
+        saveSnapshotAt(s, SNAPSHOT_TIME, SNAPSHOT_PATH);
+    }
+    exitOnSchedulerError(SchedulerRun(s));
+    if (TIMELINE_PATH != NULL || EVENTS_PATH != NULL)
+    {
+        closeTimeline(&timeline, TIMELINE_PATH, EVENTS_PATH);
+    }
+    if (JOBS_PATH != NULL)
+    {
+        writeJobRecords(s, JOBS_PATH);
+    }
 
-        
-    int processesCompleted = 0;
-    while (processesCompleted != numberOfFiles)
-    {
-        // Each while-loop iteration increments TIME_ELAPSED by 1, or by TIME_QUANTUM if round robin executes.
-        // At each while-loop iteration, check the arrival time, if arrival time is greater or equals to time_elapsed
-        // add this file into the ready queue
-        populateQueueIfArrive(numberOfFiles, fileTable, readyQueue);
-        HybridRoundRobin(TIME_QUANTUM, readyQueue, fileTable, completedFileTable, numberOfFiles, &processesCompleted, &completedIndex);
-        UpdateWaitingTimes(readyQueue);
-    }
-    float averageTurnaroundTime = GetAverageTurnaroundTime(completedFileTable, numberOfFiles);
-    float maxTurn = GetMaxTurnAroundTime(completedFileTable, numberOfFiles);
-    float averageWaitingTime = GetAverageWaitingTime(completedFileTable, numberOfFiles);
-    float maxWait = GetMaxWaitingTime(completedFileTable, numberOfFiles);
-    float minWait = GetMinWaitingTime(completedFileTable, numberOfFiles);
-    float minTurn = GetMinTurnAroundTime(completedFileTable, numberOfFiles);
-    printOrderOfCompletion(completedFileTable, numberOfFiles);
-    fclose(fp);
-    freeAllocatedMemory(readyQueue);
+    schedulerResults results;
+    SchedulerGetResults(s, &results);
+    printResults(&results);
+    printOrderOfCompletion(s);
+    if (EXTENDED_REPORT)
+    {
+        printPercentiles(s);
+        printContextSwitches(&results);
+        printCpuStats(s);
+    }
+    if (FAIR_SHARE || trace.priority != NULL || trace.group != NULL)
+    {
+        printClassStats(s);
+    }
+    if (PROFILE)
+    {
+        printProfile();
+    }
+    SchedulerResetProfile(false);
+    SchedulerDestroy(s);
+    freeTraceColumns(&trace);
+    free(GROUP_WEIGHTS);
     exit(1);
 }
-
-int getNumberOfFiles(FILE *fp)
+void runOnlineSimulation(FILE *fp, int TIME_QUANTUM)
 {
-    // Function returns number of files present in sample.txt.
-    // Sample.txt - last line must be an empty line (as per specifications)
-    int count = 0;
-    while(fgets(line, sizeof(line), fp) != NULL) 
+    // Online mode: processes are read from fp while the simulation runs and each completion is printed as it happens
+    // Completed processes are not kept, so memory follows the processes in flight
+    // Arrival times must not decrease, the next arrival is read ahead only when the scheduler needs to know it
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    options.timeQuantum = TIME_QUANTUM;
+    options.onCompletion = printCompletion;
+    scheduler *s = SchedulerCreate(&options);
+    if (s == NULL)
     {
-        if (line[0] != '\n')
-        { 
-            count++;
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+
+    traceParser parser;
+    initTraceParser(&parser);
+    parser.online = s;
+
+    bool endOfTrace = false;
+    while (true)
+    {
+        while (!endOfTrace && SchedulerNeedsArrival(s))
+        {
+            endOfTrace = !readOnlineTrace(fp, &parser);
         }
-        else
+        if (endOfTrace)
+        {
+            SchedulerCloseInput(s);
+        }
+        schedulerStatus status = SchedulerStep(s);
+        if (status == SCHEDULER_FINISHED)
         {
             break;
         }
+        exitOnSchedulerError(status);
     }
-    fseek(fp, 0, SEEK_SET);
-    return count;
-}
 
-void printFileTable(fileAttribute fileTable[], int numberOfFiles)
-{
-    // Accepts fileTable / completedfileTable and number of files as arguments
-    // Helper function to check contents of file table
-    printf("\t\tFID\tArrival Time\tBurst Time\tWaiting Time\tTurnaround Time\t BackUp BurstTime\tResponse Time\n");
-    for (int i = 0; i < numberOfFiles; i++)
+    schedulerResults results;
+    SchedulerGetResults(s, &results);
+    printResults(&results);
+    printPercentiles(s);
+    if (fp != stdin)
     {
-        printf("Filetable[%i]:\t%i\t%i\t\t%i\t\t%i\t\t%i\t\t %i\t\t\t%i\n", i, fileTable[i].fileID, fileTable[i].arrivalTime, fileTable[i].burstTime, fileTable[i].waitingTime, fileTable[i].turnAroundTime, fileTable[i].backUpBurstTime, fileTable[i].responseTime);
+        fclose(fp);
     }
-    printf("\n");
+    SchedulerDestroy(s);
 }
-
-void printReadyQueueEntries(readyQueueNode *readyQueue)
+bool readOnlineTrace(FILE *fp, traceParser *parser)
 {
-    // Helper function to display ready queue entries, mainly for debugging and report
-    readyQueueNode *temp = readyQueue;
-    if (ITEMS_IN_QUEUE == 0)
+    // Reads at most one line of a live trace, fgets returns as soon as the line is available
+    // Returns false once the trace has ended (end of file or empty line)
+    char block[ONLINE_READ_LINE_SIZE];
+    if (parser->finished)
     {
-        printf("Queue currently empty\n");
+        return false;
     }
-    printf("Ready Queue\tArrival Time\tBurst Time\tWaiting Time\tBackUp BurstTime\tTurnaround\tTime Added\tCompleted\tResponse time\n");
-    while (temp != NULL)
+    if (fgets(block, sizeof(block), fp) == NULL)
     {
-        if (temp->file.inQueue = true)
-        {
-            printf("\t\t%i\t\t%i\t\t%i\t\t%i\t\t\t%i\t\t%i\t\t%d\t\t%i\n", temp->file.arrivalTime, temp->file.burstTime, temp->file.waitingTime, temp->file.backUpBurstTime, temp->file.turnAroundTime, temp->file.timeAddedToQueue, temp->file.hasCompleted, temp->file.responseTime);
-            temp = temp->next;
-        }
+        endTraceLine(parser); // last line need not end with a newline
+        parser->finished = true;
+        return false;
     }
-    printf("\n");
+    feedTraceParser(parser, block, strlen(block));
+    return !parser->finished;
 }
-
-void UpdateWaitingTimes(readyQueueNode *readyQueue)
+void runParameterSweep(int argc, char *argv[])
 {
-    if (ITEMS_IN_QUEUE == 0) {
-        // guard clause, since readyqueue was malloc() if malloc successfully, readyqueue will never be null
-        return;
-    }
-     // Update waiting times of processes in queue
-    readyQueueNode *temp = readyQueue;
-    while (temp != NULL)
+    // Simulates every trace under every combination of policy, CPU count, switch cost and time quantum in the lists,
+    // spread over a pool of threads, then prints one row per simulation
+    // Each trace is read once and shared by all of its simulations, which only copy the processes they have in flight
+    int threadCount = SweepDefaultThreadCount();
+    sweepConfig defaults;
+    SweepDefaultConfig(&defaults);
+    schedulerPolicy *policies = NULL;
+    int *cpuCounts = NULL;
+    int *switchCosts = NULL;
+    int policyCount = 0;
+    int cpuCountCount = 0;
+    int switchCostCount = 0;
+    int arg = 2;
+    bool validOption = true;
+    while (arg + 2 < argc && validOption && argv[arg][0] == '-')
     {
-        if (temp->file.processing == false && temp->file.hasCompleted == false && temp->file.startedButNotComp == false)
+        if (strcmp(argv[arg], "-j") == 0)
+        {
+            threadCount = atoi(argv[arg + 1]);
+            validOption = threadCount >= 1;
+        }
+        else if (strcmp(argv[arg], "--policies") == 0 && policies == NULL)
+        {
+            policyCount = parsePolicyList(argv[arg + 1], &policies);
+        }
+        else if (strcmp(argv[arg], "--cpus") == 0 && cpuCounts == NULL)
+        {
+            cpuCountCount = parseIntegerList(argv[arg + 1], 1, "CPU count", &cpuCounts);
+        }
+        else if (strcmp(argv[arg], "--switch-cost") == 0 && switchCosts == NULL)
         {
-            temp->file.waitingTime = TIME_ELAPSED - temp->file.arrivalTime;
+            switchCostCount = parseIntegerList(argv[arg + 1], 0, "switch cost", &switchCosts);
         }
-        temp = temp->next;
+        else
+        {
+            validOption = false;
+        }
+        arg += 2;
     }
-}
-
-void HybridRoundRobin(int TIME_QUANTUM, readyQueueNode *readyQueue, fileAttribute fileTable[], fileAttribute completedFileTable[], int numberOfFiles, int *processCompleted, int *completedIndex)
-{
-    // Process files / processes in ready queue
-    // Time quantum here is dynamic and changes according to remaining burst time of process
-    // Employs dynamic time quantum in RR and SJF whenever possible
-    fileAttribute updatedFileEntry;
-    int timejump = 0;
-    int newProcessAddedToQueue = 0;
-    int uncompletedProcessesInQueue = CountUncompletedProcessesInQueue(readyQueue);
-   
-    if (uncompletedProcessesInQueue == 0)
+    if (!validOption || arg + 1 >= argc)
     {
-        TIME_ELAPSED++;
-        return;
+        printf("Invalid usage: <./assignment> --sweep [-j threads] [--policies <hybrid,rr,...|all>] [--cpus <counts>] [--switch-cost <times>]\n");
+        printf("                               <quanta, e.g. 1-64 or 2,5,10> <filename.txt>...\n");
+        exit(1);
+    }
+    if (policies == NULL)
+    {
+        policyCount = 1;
+        policies = allocateColumn(1, sizeof(schedulerPolicy));
+        policies[0] = defaults.policy;
+    }
+    if (cpuCounts == NULL)
+    {
+        cpuCountCount = 1;
+        cpuCounts = allocateColumn(1, sizeof(int));
+        cpuCounts[0] = defaults.cpuCount;
+    }
+    if (switchCosts == NULL)
+    {
+        switchCostCount = 1;
+        switchCosts = allocateColumn(1, sizeof(int));
+        switchCosts[0] = defaults.switchCost;
     }
 
-    readyQueueNode *temp = readyQueue;
-    readyQueueNode *newTemp = readyQueue;
+    int *timeQuanta;
+    int quantumCount = parseIntegerList(argv[arg], 1, "time quantum", &timeQuanta);
+    arg++;
 
-    if (uncompletedProcessesInQueue == 1)
+    // Configurations ordered by policy, then CPU count, then switch cost, then time quantum
+    long long configCount = (long long)policyCount * cpuCountCount * switchCostCount * quantumCount;
+    int traceCount = argc - arg;
+    if (configCount * traceCount > INT_MAX)
+    {
+        printf("Too many simulations in the sweep\n");
+        exit(1);
+    }
+    sweepConfig *configs = allocateColumn((int)configCount, sizeof(sweepConfig));
+    int config = 0;
+    for (int p = 0; p < policyCount; p++)
     {
-        // Only 1 uncompleted process, start processing this file
-        while (temp != NULL)
+        for (int c = 0; c < cpuCountCount; c++)
         {
-            if (temp->file.hasCompleted == false)
+            for (int w = 0; w < switchCostCount; w++)
             {
-                break;
+                for (int q = 0; q < quantumCount; q++)
+                {
+                    configs[config].policy = policies[p];
+                    configs[config].cpuCount = cpuCounts[c];
+                    configs[config].switchCost = switchCosts[w];
+                    configs[config].timeQuantum = timeQuanta[q];
+                    config++;
+                }
             }
-            temp = temp->next;
         }
+    }
 
-        temp->file.processing = true;
-        // Selecting a new time quantum
-        if (TIME_QUANTUM >= temp->file.backUpBurstTime)
+    traceColumns *columns = allocateColumn(traceCount, sizeof(traceColumns));
+    sweepTrace *traces = allocateColumn(traceCount, sizeof(sweepTrace));
+    for (int i = 0; i < traceCount; i++)
+    {
+        FILE *fp = fopen(argv[arg + i], "rb");
+        if (fp == NULL)
         {
-            timejump = temp->file.backUpBurstTime; // variable used to increment time elapsed by
+            printf("<%s> does not exist!\n", argv[arg + i]);
+            exit(1);
         }
+        initTraceColumns(&columns[i]);
+        readTraceFile(fp, &columns[i]);
+        fclose(fp);
+        traces[i].name = argv[arg + i];
+        traces[i].arrivalTime = columns[i].arrivalTime;
+        traces[i].burstTime = columns[i].burstTime;
+        traces[i].priority = columns[i].priority;
+        traces[i].group = columns[i].group;
+        traces[i].groupCount = columns[i].groupCount;
+        traces[i].count = columns[i].count;
+    }
 
-        else if (TIME_QUANTUM <= temp->file.backUpBurstTime)
+    int runCount = traceCount * (int)configCount;
+    sweepResult *results = allocateColumn(runCount, sizeof(sweepResult));
+    exitOnSchedulerError(RunSweepConfigs(traces, traceCount, configs, (int)configCount, threadCount, results));
+
+    printf("trace\tpolicy\tCPUs\tswitch cost\ttime quantum\taverage turnaround time\tmaximum turnaround time\taverage waiting time\tmaximum waiting time\tminimum waiting time\tminimum turnaround time\n");
+    for (int i = 0; i < runCount; i++)
+    {
+        sweepResult *result = &results[i];
+        sweepConfig *run = &configs[result->config];
+        printf("%s\t%s\t%i\t%i\t%i\t", traces[result->trace].name, SchedulerPolicyName(run->policy), run->cpuCount, run->switchCost, run->timeQuantum);
+        if (result->status != SCHEDULER_OK && result->status != SCHEDULER_FINISHED)
         {
-            timejump = DEFAULT_TIME_QUANTUM;
+            printf("%s\n", SchedulerStatusString(result->status));
+            continue;
         }
-        TIME_QUANTUM = timejump;
+        printf("%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n", result->results.averageTurnaroundTime, result->results.maxTurnaroundTime,
+               result->results.averageWaitingTime, result->results.maxWaitingTime,
+               result->results.minWaitingTime, result->results.minTurnaroundTime);
     }
 
-    else if (uncompletedProcessesInQueue > 1)
+    for (int i = 0; i < traceCount; i++)
+    {
+        freeTraceColumns(&columns[i]);
+    }
+    free(columns);
+    free(traces);
+    free(results);
+    free(configs);
+    free(policies);
+    free(cpuCounts);
+    free(switchCosts);
+    free(timeQuanta);
+}
+void runBenchmark(int argc, char *argv[])
+{
+    // Simulates seeded synthetic workloads from BENCHMARK_MIN_JOBS up to --max-jobs processes, 10x per step
+    // Only adding the columns and running the simulation is timed, generating the workload is not
+    // Peak RSS is the high water mark of the whole process, sizes run smallest first so it tracks the current size
+    unsigned long long seed = 1;
+    int maxJobs = BENCHMARK_MAX_JOBS;
+    bool selected[WORKLOAD_KIND_COUNT] = {false};
+    bool anySelected = false;
+    bool validOption = true;
+    for (int arg = 2; arg < argc && validOption; arg++)
     {
-        // More than 1 process in queue obtain new burst time and process for scheduling 
-        temp->file.processing = false;
-        if(temp->file.saved == false){
-            temp->file.timeStopped = TIME_ELAPSED;
-            temp->file.startedButNotComp = true;
-            temp->file.saved = true;
+        if (strcmp(argv[arg], "--seed") == 0 && arg + 1 < argc)
+        {
+            seed = strtoull(argv[arg + 1], NULL, 10);
+            arg++;
+        }
+        else if (strcmp(argv[arg], "--max-jobs") == 0 && arg + 1 < argc)
+        {
+            maxJobs = atoi(argv[arg + 1]);
+            validOption = maxJobs >= BENCHMARK_MIN_JOBS;
+            arg++;
+        }
+        else
+        {
+            int kind = ParseWorkloadKind(argv[arg]);
+            validOption = kind != -1;
+            if (validOption)
+            {
+                selected[kind] = true;
+                anySelected = true;
+            }
         }
-        temp->file.calculated = false;
-        int fid = getLowestRemainingBurstTime(readyQueue);
-        while (newTemp != NULL)
+    }
+    if (!validOption)
+    {
+        printf("Invalid usage: <./assignment> --benchmark [--seed <n>] [--max-jobs <n>] [uniform|poisson|bimodal|pareto|bursty]...\n");
+        exit(1);
+    }
+
+    // Columns are allocated once for the largest size and regenerated for each run
+    int *arrivalTime = allocateColumn(maxJobs, sizeof(int));
+    int *burstTime = allocateColumn(maxJobs, sizeof(int));
+    printf("workload\tjobs\twall time (s)\tevents\tevents/s\tpeak RSS (MiB)\n");
+    for (long long size = BENCHMARK_MIN_JOBS; size <= maxJobs; size *= 10)
+    {
+        for (int kind = 0; kind < WORKLOAD_KIND_COUNT; kind++)
         {
-            if (fid == newTemp->file.fileID)
+            if (anySelected && !selected[kind])
+            {
+                continue;
+            }
+            GenerateWorkload(kind, (int)size, seed, arrivalTime, burstTime);
+
+            schedulerOptions options;
+            SchedulerDefaultOptions(&options);
+            scheduler *s = SchedulerCreate(&options);
+            if (s == NULL)
             {
-                temp = newTemp;
-                break;
+                printf("Failed to allocate memory\n");
+                exit(1);
             }
-            newTemp = newTemp->next;
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            exitOnSchedulerError(SchedulerAddJobColumns(s, arrivalTime, burstTime, (int)size));
+            exitOnSchedulerError(SchedulerRun(s));
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            schedulerResults results;
+            SchedulerGetResults(s, &results);
+            SchedulerDestroy(s);
+
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            double seconds = elapsedSeconds(&start, &end);
+            printf("%s\t%lld\t%.4f\t%lld\t%.0f\t%.1f\n", WorkloadKindName(kind), size, seconds, results.events,
+                   seconds > 0 ? results.events / seconds : 0.0, usage.ru_maxrss / 1024.0); // ru_maxrss is in KiB
+            fflush(stdout);
         }
-        // Process the file with lowest remaining burst time instead
-        temp->file.processing = true;
-        //temp->file.hasStarted = true;
-        timejump = temp->file.backUpBurstTime;
-        TIME_QUANTUM = timejump;
     }
-  
-    for (int i = 0; i < timejump; i++)
+    free(arrivalTime);
+    free(burstTime);
+}
+double elapsedSeconds(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+void runGoldenCheck(int argc, char *argv[])
+{
+    // Regression check against recorded per-process results, exits 0 if every trace matches and 1 otherwise
+    // The golden file of <dir>/<name>.txt is <dir>/expected/<name>.csv, recorded with --jobs
+    bool passed = true;
+    for (int arg = 2; arg < argc; arg++)
     {
-        // This for loop iteratively increments the time elapsed, allows us to add new files to our queue at 
-        // each time interval i.e., maintains order in which files are 'ready' 
-        if (temp->file.responseTime == -1 && temp->file.hasCompleted == false)
+        if (!checkGolden(argv[arg]))
         {
-            temp->file.responseTime = TIME_ELAPSED - temp->file.arrivalTime; 
+            passed = false;
         }
-        temp->file.backUpBurstTime -= 1;
-        if (temp->file.backUpBurstTime == 0 && temp->file.hasCompleted == false)
+    }
+    exit(passed ? 0 : 1);
+}
+bool checkGolden(const char *tracePath)
+{
+    // Completion order and every metric of every process, the averages printed in batch mode follow from these
+    char goldenPath[4096];
+    goldenPathFor(tracePath, goldenPath, sizeof(goldenPath));
+    FILE *fp = fopen(tracePath, "rb");
+    FILE *golden = fopen(goldenPath, "rb");
+    if (fp == NULL || golden == NULL)
+    {
+        printf("FAIL %s: <%s> does not exist!\n", tracePath, fp == NULL ? tracePath : goldenPath);
+        if (fp != NULL)
         {
-            temp->file.hasCompleted = true;
-            temp->file.processing = false;
-            temp->file.turnAroundTime = temp->file.burstTime + temp->file.waitingTime;
-            updatedFileEntry = temp->file;
-            completedFileTable[*completedIndex] = updatedFileEntry;
-            *processCompleted = *processCompleted + 1;
-            *completedIndex = *completedIndex + 1;
-            uncompletedProcessesInQueue = CountUncompletedProcessesInQueue(readyQueue);
+            fclose(fp);
         }
-        else if(temp->file.backUpBurstTime > 0 && temp->file.calculated == false){
-            temp->file.waitingTime += (TIME_ELAPSED - temp->file.timeStopped);
-            temp->file.calculated = true;
-            temp->file.saved = false;
-            temp->file.startedButNotComp = false;
+        if (golden != NULL)
+        {
+            fclose(golden);
         }
+        return false;
+    }
+    traceColumns trace;
+    initTraceColumns(&trace);
+    readTraceFile(fp, &trace);
+    fclose(fp);
 
-        populateQueueIfArrive(numberOfFiles, fileTable, readyQueue);
-        if(temp->file.startedButNotComp==false){
-            UpdateWaitingTimes(readyQueue);
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    options.retainCompletions = true;
+    scheduler *s = SchedulerCreate(&options);
+    if (s == NULL)
+    {
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+    exitOnSchedulerError(SchedulerAddJobColumns(s, trace.arrivalTime, trace.burstTime, trace.count));
+    exitOnSchedulerError(SchedulerRun(s));
+
+    static const char *const fields[GOLDEN_FIELDS] = {"id", "arrival", "burst", "completion", "wait", "turnaround", "response"};
+    int count = SchedulerGetCompletedCount(s);
+    int row = 0;
+    bool passed = true;
+    schedulerCompletion completion;
+    int expected[GOLDEN_FIELDS];
+    fscanf(golden, "%*[^\n]"); // header
+    while (passed && fscanf(golden, "%d,%d,%d,%d,%d,%d,%d", &expected[0], &expected[1], &expected[2], &expected[3],
+                            &expected[4], &expected[5], &expected[6]) == GOLDEN_FIELDS)
+    {
+        if (row == count)
+        {
+            printf("FAIL %s: %i processes completed, golden has more\n", tracePath, count);
+            passed = false;
+            break;
         }
-        TIME_ELAPSED++;
+        SchedulerGetCompletion(s, row, &completion);
+        int actual[GOLDEN_FIELDS] = {completion.process + 1, completion.arrivalTime, completion.burstTime, completion.completionTime,
+                                     completion.waitingTime, completion.turnAroundTime, completion.responseTime};
+        for (int field = 0; field < GOLDEN_FIELDS && passed; field++)
+        {
+            if (actual[field] != expected[field])
+            {
+                printf("FAIL %s: completion %i: %s is %i, expected %i\n", tracePath, row + 1, fields[field], actual[field], expected[field]);
+                passed = false;
+            }
+        }
+        row++;
+    }
+    if (passed && row != count)
+    {
+        printf("FAIL %s: %i processes completed, golden has %i\n", tracePath, count, row);
+        passed = false;
+    }
+    if (passed)
+    {
+        printf("PASS %s\n", tracePath);
     }
+    fclose(golden);
+    SchedulerDestroy(s);
+    freeTraceColumns(&trace);
+    return passed;
 }
-void populateQueueIfArrive(int numberOfFiles, fileAttribute fileTable[], readyQueueNode *readyQueue)
+void goldenPathFor(const char *tracePath, char *goldenPath, size_t size)
 {
-    // Populates ready queue by invoking AddToReadyQueue
-    for (int i = 0; i < numberOfFiles; i++)
+    const char *slash = strrchr(tracePath, '/');
+    const char *name = slash == NULL ? tracePath : slash + 1;
+    int directoryLength = (int)(name - tracePath);
+    const char *extension = strrchr(name, '.');
+    int nameLength = extension == NULL ? (int)strlen(name) : (int)(extension - name);
+    snprintf(goldenPath, size, "%.*sexpected/%.*s.csv", directoryLength, tracePath, nameLength, name);
+}
+void runDifferentialCheck(int argc, char *argv[])
+{
+    // Random traces from the workload generator, each simulated by the scheduler and by the slow reference
+    // The first disagreement is shrunk to a minimal trace that still disagrees, printed as a trace file, then exits 1
+    unsigned long long seed = 1;
+    int runs = DIFFERENTIAL_RUNS;
+    int maxJobs = DIFFERENTIAL_MAX_JOBS;
+    bool validOption = true;
+    for (int arg = 2; arg < argc && validOption; arg += 2)
     {
-        if (ITEMS_IN_QUEUE == numberOfFiles)
+        validOption = arg + 1 < argc;
+        if (validOption && strcmp(argv[arg], "--seed") == 0)
         {
-            // Queue contains all files
-            return;
+            seed = strtoull(argv[arg + 1], NULL, 10);
         }
-        else if (fileTable[i].inQueue == true)
+        else if (validOption && strcmp(argv[arg], "--runs") == 0)
         {
-            // file already in queue, ignore
-            continue;
+            runs = atoi(argv[arg + 1]);
+            validOption = runs >= 1;
         }
-
-        else if (fileTable[i].hasCompleted == true)
+        else if (validOption && strcmp(argv[arg], "--max-jobs") == 0)
         {
-            // file already in queue and completed, ignore
-            continue;
+            maxJobs = atoi(argv[arg + 1]);
+            validOption = maxJobs >= 1;
+        }
+        else
+        {
+            validOption = false;
         }
+    }
+    if (!validOption)
+    {
+        printf("Invalid usage: <./assignment> --differential [--seed <n>] [--runs <n>] [--max-jobs <n>]\n");
+        exit(1);
+    }
 
-        else if (TIME_ELAPSED > fileTable[i].arrivalTime && fileTable[i].inQueue == false)
+    int *arrivalTime = allocateColumn(maxJobs, sizeof(int));
+    int *burstTime = allocateColumn(maxJobs, sizeof(int));
+    char detail[256];
+    for (int run = 0; run < runs; run++)
+    {
+        // Every workload kind, trace sizes and time quantums vary from run to run
+        unsigned long long runSeed = seed * 1000003ULL + run;
+        int count = 1 + (int)(runSeed % maxJobs);
+        int timeQuantum = 1 + (run / WORKLOAD_KIND_COUNT) % (2 * DEFAULT_TIME_QUANTUM);
+        GenerateWorkload(run % WORKLOAD_KIND_COUNT, count, runSeed, arrivalTime, burstTime);
+        if (!findMismatch(arrivalTime, burstTime, count, timeQuantum, detail, sizeof(detail)))
         {
-            // time has not elapsed for process to arrive ignore
             continue;
         }
-
-        else if (fileTable[i].arrivalTime <= TIME_ELAPSED && fileTable[i].inQueue == false)
+        printf("run %i (%s workload, time quantum %i): %s\n", run, WorkloadKindName(run % WORKLOAD_KIND_COUNT), timeQuantum, detail);
+        shrinkTrace(arrivalTime, burstTime, &count, timeQuantum);
+        findMismatch(arrivalTime, burstTime, count, timeQuantum, detail, sizeof(detail));
+        printf("shrunk to %i processes: %s\n", count, detail);
+        for (int i = 0; i < count; i++)
         {
-            // File has arrived and is not yet in queue, i.e., add to queue 
-            fileTable[i].hasArrived = true;
-            fileTable[i].inQueue = true;
-            fileTable[i].timeAddedToQueue = TIME_ELAPSED;
-            AddToReadyQueue(fileTable[i], readyQueue);
+            printf("%i\t%i\n", arrivalTime[i], burstTime[i]);
         }
+        exit(1);
     }
+    printf("%i random traces agree with the reference\n", runs);
+    free(arrivalTime);
+    free(burstTime);
+    exit(0);
 }
-
-void AddToReadyQueue(fileAttribute fileTableEntry, readyQueueNode *readyQueue)
+bool findMismatch(const int *arrivalTime, const int *burstTime, int count, int timeQuantum, char *detail, size_t size)
 {
-    // Adds process to ready queue once the arrival time is lower or equals to time elapsed
-    readyQueueNode *newNode = malloc(sizeof(readyQueueNode));
-    newNode->file = fileTableEntry;
-    newNode->next = NULL;
-    
-    // If queue initially empty, simply add file entry to head of list
-    if (ITEMS_IN_QUEUE == 0)
+    // true if the scheduler and the reference disagree on the trace, detail then names the first difference
+    schedulerCompletion *expected = allocateColumn(count, sizeof(schedulerCompletion));
+    if (!ReferenceSchedule(arrivalTime, burstTime, count, timeQuantum, expected))
     {
-        readyQueue->file = newNode->file;
-        readyQueue->next = NULL;
-        readyQueue->file.inQueue = true;
-        ITEMS_IN_QUEUE++;
-        return;
+        printf("Failed to allocate memory\n");
+        exit(1);
     }
-
-    // If queue not empty add to back of queue
-    readyQueueNode *temp = readyQueue;
-    while (temp->next != NULL)
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    options.timeQuantum = timeQuantum;
+    options.retainCompletions = true;
+    scheduler *s = SchedulerCreate(&options);
+    if (s == NULL)
     {
-        temp = temp->next;
-    }
-    
-    temp->next = malloc(sizeof(readyQueueNode));
-
-    if (temp->next == NULL) {
         printf("Failed to allocate memory\n");
-        exit(2);
+        exit(1);
     }
+    exitOnSchedulerError(SchedulerAddJobColumns(s, arrivalTime, burstTime, count));
+    exitOnSchedulerError(SchedulerRun(s));
 
-    temp->next->file = newNode->file;
-    temp->next->next = NULL;
-    readyQueue->file.inQueue = true;
-    ITEMS_IN_QUEUE++;
-    free(newNode);
-    return;
-}
-
-//checking that input is integer
-int validate(char *str)
-{
-    while(*str)
+    bool mismatch = SchedulerGetCompletedCount(s) != count;
+    if (mismatch)
+    {
+        snprintf(detail, size, "%i of %i processes completed", SchedulerGetCompletedCount(s), count);
+    }
+    schedulerCompletion actual;
+    for (int i = 0; i < count && !mismatch; i++)
     {
-        if(!isdigit(*str)){
-            return 0; //return 0 if failure
+        SchedulerGetCompletion(s, i, &actual);
+        schedulerCompletion *reference = &expected[i];
+        mismatch = actual.process != reference->process || actual.completionTime != reference->completionTime ||
+                   actual.waitingTime != reference->waitingTime || actual.turnAroundTime != reference->turnAroundTime ||
+                   actual.responseTime != reference->responseTime;
+        if (mismatch)
+        {
+            snprintf(detail, size, "completion %i is Process-%i at %i (waiting %i, response %i), reference Process-%i at %i (waiting %i, response %i)",
+                     i + 1, actual.process + 1, actual.completionTime, actual.waitingTime, actual.responseTime,
+                     reference->process + 1, reference->completionTime, reference->waitingTime, reference->responseTime);
         }
-        str++; //proceed to next char in string
     }
-    return 1; //return 1 if is digit
+    SchedulerDestroy(s);
+    free(expected);
+    return mismatch;
 }
-
-
-int getLowestRemainingBurstTime(readyQueueNode *readyQueue)
+void shrinkTrace(int *arrivalTime, int *burstTime, int *count, int timeQuantum)
 {
-    // Obtain file ID of ready processes that has the lowest remaining burst time
-    // if multiple process with same remaining burst times return fid of process with lowest arrival time (FIFO)
-    readyQueueNode *temp = readyQueue;
-    readyQueueNode *newTemp = readyQueue;
-
-    int lowestBurstTime;
-    int fid;
-    int arrival;
-
-    while (temp != NULL)
+    // Greedy shrinking until nothing more can be taken away: drop processes, then lower arrival and burst times,
+    // keeping each step only if the trace still disagrees
+    bool shrunk = true;
+    while (shrunk)
     {
-        // Ignore if file has completed
-        if (temp->file.hasCompleted == true)
+        shrunk = false;
+        for (int i = 0; i < *count && *count > 1; i++)
         {
-            temp = temp->next;
-            continue;
+            int arrival = arrivalTime[i];
+            int burst = burstTime[i];
+            memmove(&arrivalTime[i], &arrivalTime[i + 1], (*count - i - 1) * sizeof(int));
+            memmove(&burstTime[i], &burstTime[i + 1], (*count - i - 1) * sizeof(int));
+            char detail[256];
+            if (findMismatch(arrivalTime, burstTime, *count - 1, timeQuantum, detail, sizeof(detail)))
+            {
+                (*count)--;
+                i--;
+                shrunk = true;
+                continue;
+            }
+            memmove(&arrivalTime[i + 1], &arrivalTime[i], (*count - i - 1) * sizeof(int));
+            memmove(&burstTime[i + 1], &burstTime[i], (*count - i - 1) * sizeof(int));
+            arrivalTime[i] = arrival;
+            burstTime[i] = burst;
         }
-        // obtain fid of file burst time
-        if (temp->file.backUpBurstTime > 0)
+        for (int i = 0; i < *count; i++)
         {
-            lowestBurstTime = temp->file.backUpBurstTime;
-            fid = temp->file.fileID;
-            arrival = temp->file.timeAddedToQueue;
+            if (shrinkValue(&arrivalTime[i], 0, arrivalTime, burstTime, *count, timeQuantum))
+            {
+                shrunk = true;
+            }
+            if (shrinkValue(&burstTime[i], 1, arrivalTime, burstTime, *count, timeQuantum))
+            {
+                shrunk = true;
+            }
         }
-        temp = temp->next;
-        break;
     }
-
-    while (newTemp != NULL)
+}
+bool shrinkValue(int *value, int lowest, const int *arrivalTime, const int *burstTime, int count, int timeQuantum)
+{
+    // Lowers one time of the trace as far as the disagreement allows: straight to lowest, else halfway, else by 1
+    char detail[256];
+    int original = *value;
+    int candidates[3] = {lowest, lowest + (*value - lowest) / 2, *value - 1};
+    for (int c = 0; c < 3; c++)
     {
-        // find fid of file with lowest burst time
-        if (lowestBurstTime > newTemp->file.backUpBurstTime && newTemp->file.hasCompleted == false)
+        if (candidates[c] < lowest || candidates[c] >= *value)
         {
-            lowestBurstTime = newTemp->file.backUpBurstTime;
-            fid = newTemp->file.fileID;
+            continue;
         }
-
-        // this allows a FIFO approach if two processes have same remaining burst times
-        else if (lowestBurstTime == newTemp->file.backUpBurstTime)
+        int previous = *value;
+        *value = candidates[c];
+        if (findMismatch(arrivalTime, burstTime, count, timeQuantum, detail, sizeof(detail)))
         {
-            if (arrival > newTemp->file.arrivalTime)
-            {
-                lowestBurstTime = newTemp->file.backUpBurstTime;
-                fid = newTemp->file.fileID;
-                arrival = newTemp->file.arrivalTime;
-                break;
-            }
+            return true;
         }
-        newTemp = newTemp->next;
+        *value = previous;
     }
-    return fid;
+    return *value != original;
 }
-
-int CountUncompletedProcessesInQueue(readyQueueNode *readyQueue)
+void runPolicyComparison(const char *path, int switchCost)
 {
-    // returns uncompleted processes in queue i.e., hasCompleted flag not set (remaining burst time > 0)
-    int uncompletedProcesses = 0;
-
-    if (ITEMS_IN_QUEUE == 0) {
-        return uncompletedProcesses;
+    // Simulates one trace under every built-in policy with the fixed time quantum, then the hybrid and RR policies
+    // under each adaptive time quantum rule, printing one row per simulation
+    // The trace is read once, each simulation borrows its columns
+    const char *quantumRules[SCHEDULER_QUANTUM_MODE_COUNT] = {"fixed", "median", "80th percentile", "mean + 1 stddev"};
+    schedulerPolicy adaptivePolicies[2] = {SCHEDULER_POLICY_HYBRID, SCHEDULER_POLICY_RR};
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        printf("<%s> does not exist!\n", path);
+        exit(1);
     }
+    traceColumns trace;
+    initTraceColumns(&trace);
+    readTraceFile(fp, &trace);
+    fclose(fp);
 
-    readyQueueNode *temp = readyQueue;
-    while (temp != NULL)
+    printf("policy\tquantum rule\ttime quantum\taverage turnaround time\tmaximum turnaround time\taverage waiting time\tmaximum waiting time\tminimum waiting time\tminimum turnaround time\taverage response time\tcontext switches\tpreemptions\taverage dispatches per process\t99th percentile waiting time\t99th percentile response time\n");
+    int runCount = SCHEDULER_POLICY_COUNT + 2 * (SCHEDULER_QUANTUM_MODE_COUNT - 1);
+    for (int run = 0; run < runCount; run++)
     {
-        if (temp->file.hasCompleted == false)
+        schedulerOptions options;
+        SchedulerDefaultOptions(&options);
+        options.switchCost = switchCost;
+        options.groupCount = trace.groupCount;
+        if (run < SCHEDULER_POLICY_COUNT)
         {
-            uncompletedProcesses++;
+            options.policy = run;
         }
-        temp = temp->next;
-    }
-    return uncompletedProcesses;
-}
+        else
+        {
+            options.policy = adaptivePolicies[(run - SCHEDULER_POLICY_COUNT) / (SCHEDULER_QUANTUM_MODE_COUNT - 1)];
+            options.quantumMode = 1 + (run - SCHEDULER_POLICY_COUNT) % (SCHEDULER_QUANTUM_MODE_COUNT - 1);
+        }
+        scheduler *s = SchedulerCreate(&options);
+        if (s == NULL)
+        {
+            printf("Failed to allocate memory\n");
+            exit(1);
+        }
+        exitOnSchedulerError(SchedulerAddJobClassColumns(s, trace.arrivalTime, trace.burstTime, trace.priority, trace.group, trace.count));
+        exitOnSchedulerError(SchedulerRun(s));
 
-// Functions that return average or max/min burst and waiting times 
-float GetAverageWaitingTime(fileAttribute completedFileTable[], int numberOfFiles) 
-{
-    float averageWaitingTime = 0.0;
-    for (int i = 0; i < numberOfFiles; i++) {
-        averageWaitingTime += completedFileTable[i].waitingTime;
+        // An adaptive time quantum is printed as it was at the end of the simulation
+        schedulerResults results;
+        SchedulerGetResults(s, &results);
+        schedulerHistogram waiting;
+        schedulerHistogram response;
+        SchedulerGetHistogram(s, SCHEDULER_METRIC_WAITING_TIME, &waiting);
+        SchedulerGetHistogram(s, SCHEDULER_METRIC_RESPONSE_TIME, &response);
+        printf("%s\t%s\t%i\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%lli\t%lli\t%.2f\t%i\t%i\n", SchedulerPolicyName(options.policy),
+               quantumRules[options.quantumMode], results.timeQuantum,
+               results.averageTurnaroundTime, results.maxTurnaroundTime, results.averageWaitingTime, results.maxWaitingTime,
+               results.minWaitingTime, results.minTurnaroundTime, results.averageResponseTime,
+               results.contextSwitches, results.preemptions, results.averageDispatches,
+               SchedulerHistogramPercentile(&waiting, 99.0), SchedulerHistogramPercentile(&response, 99.0));
+        SchedulerDestroy(s);
     }
-    averageWaitingTime = averageWaitingTime/numberOfFiles;
-    printf("average waiting time: %.2f\n", averageWaitingTime);
-    return averageWaitingTime;
+    freeTraceColumns(&trace);
 }
-
-float GetAverageTurnaroundTime(fileAttribute completedFileTable[], int numberOfFiles) 
+void saveSnapshotAt(scheduler *s, int time, const char *path)
 {
-    float averageTurnAroundTime = 0.0;
-    for (int i = 0; i < numberOfFiles; i++){
-        averageTurnAroundTime += completedFileTable[i].turnAroundTime;
+    // Steps up to the first event at or after time and saves the state there, the run then carries on as usual
+    SchedulerCloseInput(s);
+    schedulerStatus status = SCHEDULER_OK;
+    while (SchedulerGetTime(s) < time && status == SCHEDULER_OK)
+    {
+        status = SchedulerStep(s);
     }
-    averageTurnAroundTime = averageTurnAroundTime/numberOfFiles;
-    printf("average turnaround time: %.2f\n", averageTurnAroundTime);
-    return averageTurnAroundTime;
+    exitOnSchedulerError(status);
+    FILE *fp = createOutputFile(path);
+    status = SchedulerSaveSnapshot(s, fp);
+    if (fclose(fp) != 0 && status == SCHEDULER_OK)
+    {
+        status = SCHEDULER_IO_ERROR;
+    }
+    exitOnSchedulerError(status);
+    printf("Snapshot at time %i written to <%s>\n", SchedulerGetTime(s), path);
 }
+void runRestoredSimulation(const char *snapshotPath, const char *tracePath)
+{
+    // What-if run: continues a snapshot from --snapshot with the processes of an optional trace added,
+    // which must arrive no earlier than the snapshot. Only the rest of the run is simulated
+    FILE *fp = fopen(snapshotPath, "rb");
+    if (fp == NULL)
+    {
+        printf("<%s> does not exist!\n", snapshotPath);
+        exit(1);
+    }
+    scheduler *s;
+    schedulerStatus status = SchedulerLoadSnapshot(fp, NULL, &s);
+    fclose(fp);
+    exitOnSchedulerError(status);
 
-float GetMaxWaitingTime(fileAttribute completedFileTable[], int numberOfFiles) {
-    float maxWaitTime = completedFileTable[0].waitingTime;
-    for (int i = 1; i < numberOfFiles; i++){
-        if (maxWaitTime < completedFileTable[i].waitingTime) {
-            maxWaitTime = completedFileTable[i].waitingTime;
+    // Added processes are numbered after those of the snapshot, the columns may be borrowed so they outlive the run
+    traceColumns trace;
+    initTraceColumns(&trace);
+    if (tracePath != NULL)
+    {
+        fp = fopen(tracePath, "rb");
+        if (fp == NULL)
+        {
+            printf("<%s> does not exist!\n", tracePath);
+            exit(1);
         }
+        readTraceFile(fp, &trace);
+        fclose(fp);
+        status = SchedulerAddJobClassColumns(s, trace.arrivalTime, trace.burstTime, trace.priority, trace.group, trace.count);
+        if (status == SCHEDULER_ARRIVAL_OUT_OF_ORDER)
+        {
+            printf("Processes added to the snapshot must arrive at or after time %i\n", SchedulerGetTime(s));
+            exit(1);
+        }
+        exitOnSchedulerError(status);
     }
-    printf("maximum waiting time: %.2f\n", maxWaitTime);
-    return maxWaitTime;
-}
+    exitOnSchedulerError(SchedulerRun(s));
 
-float GetMinWaitingTime(fileAttribute completedFileTable[], int numberOfFiles) {
-    float minWaitTime = completedFileTable[0].waitingTime;
-    for (int i = 1; i < numberOfFiles; i++){
-        if (minWaitTime > completedFileTable[i].waitingTime) {
-            minWaitTime = completedFileTable[i].waitingTime;
+    schedulerResults results;
+    SchedulerGetResults(s, &results);
+    printResults(&results);
+    printOrderOfCompletion(s);
+    SchedulerDestroy(s);
+    freeTraceColumns(&trace);
+}
+int parseIntegerList(const char *list, int minimum, const char *what, int **values)
+{
+    // Parses a comma separated list of values and inclusive ranges (e.g. 1-8,16,32) into a new array
+    // Returns the number of values, exits on anything below minimum, what names the list in the error
+    int count = 0;
+    int capacity = 16;
+    int *parsed = allocateColumn(capacity, sizeof(int));
+    const char *cursor = list;
+    while (true)
+    {
+        char *end;
+        long first = strtol(cursor, &end, 10);
+        long last = first;
+        if (end != cursor && *end == '-')
+        {
+            cursor = end + 1;
+            last = strtol(cursor, &end, 10);
+        }
+        if (end == cursor || first < minimum || last < first || last > INT_MAX || (*end != ',' && *end != '\0'))
+        {
+            printf("Invalid %s list <%s>\n", what, list);
+            exit(1);
+        }
+        for (long value = first; value <= last; value++)
+        {
+            if (count == capacity)
+            {
+                capacity *= 2;
+                int *grown = realloc(parsed, (size_t)capacity * sizeof(int));
+                if (grown == NULL)
+                {
+                    printf("Failed to allocate memory\n");
+                    exit(1);
+                }
+                parsed = grown;
+            }
+            parsed[count] = (int)value;
+            count++;
+        }
+        if (*end == '\0')
+        {
+            break;
+        }
+        cursor = end + 1;
+    }
+    *values = parsed;
+    return count;
+}
+int parsePolicyList(const char *list, schedulerPolicy **policies)
+{
+    // Parses a comma separated list of policy names (e.g. hybrid,rr,srtf), or all for every built-in policy
+    // Returns the number of policies, exits on an unknown name
+    static const char *const names[SCHEDULER_POLICY_COUNT] = {"hybrid", "fcfs", "rr", "sjf", "srtf", "mlfq", "fair-share"};
+    if (strcmp(list, "all") == 0)
+    {
+        *policies = allocateColumn(SCHEDULER_POLICY_COUNT, sizeof(schedulerPolicy));
+        for (int policy = 0; policy < SCHEDULER_POLICY_COUNT; policy++)
+        {
+            (*policies)[policy] = policy;
+        }
+        return SCHEDULER_POLICY_COUNT;
+    }
+    int count = 1;
+    for (const char *c = list; *c != '\0'; c++)
+    {
+        count += *c == ',';
+    }
+    schedulerPolicy *parsed = allocateColumn(count, sizeof(schedulerPolicy));
+    const char *cursor = list;
+    for (int i = 0; i < count; i++)
+    {
+        size_t length = strcspn(cursor, ",");
+        int policy = 0;
+        while (policy < SCHEDULER_POLICY_COUNT && (strlen(names[policy]) != length || strncmp(cursor, names[policy], length) != 0))
+        {
+            policy++;
+        }
+        if (policy == SCHEDULER_POLICY_COUNT)
+        {
+            printf("Invalid policy list <%s>, expected all or names from hybrid,fcfs,rr,sjf,srtf,mlfq,fair-share\n", list);
+            exit(1);
+        }
+        parsed[i] = policy;
+        cursor += length + 1;
+    }
+    *policies = parsed;
+    return count;
+}
+int parseWeightList(const char *list, int **weights)
+{
+    // Parses a comma separated list of group weights (e.g. 3,1,1) into a new array, weights[g] belongs to group g
+    // Returns the number of weights, exits on anything that is not a positive weight
+    int count = 1;
+    for (const char *c = list; *c != '\0'; c++)
+    {
+        count += *c == ',';
+    }
+    int *parsed = allocateColumn(count, sizeof(int));
+    const char *cursor = list;
+    for (int i = 0; i < count; i++)
+    {
+        char *end;
+        long weight = strtol(cursor, &end, 10);
+        if (end == cursor || weight < 1 || weight > INT_MAX || (*end != ',' && *end != '\0'))
+        {
+            printf("Invalid weight list <%s>\n", list);
+            exit(1);
+        }
+        parsed[i] = (int)weight;
+        cursor = end + 1;
+    }
+    *weights = parsed;
+    return count;
+}
+void printCompletion(void *context, const schedulerCompletion *completion)
+{
+    // Streams one completion record, flushed so consumers of a live trace see it straight away
+    printf("[Process-%i] completed at %i, waiting time: %i, turnaround time: %i, response time: %i\n",
+           completion->process + 1, completion->completionTime, completion->waitingTime, completion->turnAroundTime, completion->responseTime);
+    fflush(stdout);
+}
+FILE *createOutputFile(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        printf("<%s> could not be created!\n", path);
+        exit(1);
+    }
+    return fp;
+}
+void closeReport(reportWriter *writer, FILE *fp, const char *path)
+{
+    bool written = ReportWriterClose(writer);
+    if (fclose(fp) != 0 || !written)
+    {
+        printf("Failed to write <%s>\n", path);
+        exit(1);
+    }
+}
+void writeJobRecords(scheduler *s, const char *path)
+{
+    // One record per process in order of completion, id as in Process-id
+    static const char *const fields[] = {"id", "arrival", "burst", "completion", "wait", "turnaround", "response"};
+    FILE *fp = createOutputFile(path);
+    reportWriter writer;
+    if (!ReportWriterOpen(&writer, fp, ReportFormatFromPath(path), fields, 7))
+    {
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+    int count = SchedulerGetCompletedCount(s);
+    schedulerCompletion completion;
+    long long values[7];
+    for (int i = 0; i < count; i++)
+    {
+        SchedulerGetCompletion(s, i, &completion);
+        values[0] = completion.process + 1;
+        values[1] = completion.arrivalTime;
+        values[2] = completion.burstTime;
+        values[3] = completion.completionTime;
+        values[4] = completion.waitingTime;
+        values[5] = completion.turnAroundTime;
+        values[6] = completion.responseTime;
+        ReportWriteRecord(&writer, values);
+    }
+    closeReport(&writer, fp, path);
+}
+void openTimeline(timelineWriter *timeline, const char *path, const char *eventsPath, int cpuCount)
+{
+    // Either path may be NULL, the trace events start with the names of the simulated CPUs
+    static const char *const fields[] = {"cpu", "id", "start", "end"};
+    timeline->open = malloc(cpuCount * sizeof(schedulerTimeSlice));
+    timeline->toTimeline = path != NULL;
+    timeline->toEvents = eventsPath != NULL;
+    if (timeline->open == NULL ||
+        (path != NULL && !ReportWriterOpen(&timeline->writer, createOutputFile(path), ReportFormatFromPath(path), fields, 4)) ||
+        (eventsPath != NULL && !ReportWriterOpen(&timeline->events, createOutputFile(eventsPath), REPORT_JSON, NULL, 0)))
+    {
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+    for (int c = 0; c < cpuCount; c++)
+    {
+        timeline->open[c].process = -1;
+    }
+    timeline->cpuCount = cpuCount;
+    if (timeline->toEvents)
+    {
+        ReportWriteText(&timeline->events, "[");
+        writeTraceMetadata(&timeline->events, "process_name", 0, 0, "Simulated schedule", -1);
+        for (int c = 0; c < cpuCount; c++)
+        {
+            writeTraceMetadata(&timeline->events, "thread_name", 0, c, "CPU ", c);
+        }
+    }
+}
+void writeTimeSlice(void *context, const schedulerTimeSlice *slice)
+{
+    // A slice that carries on the open interval of its CPU extends it, anything else closes it
+    // Empty slices (processes with no burst time) take no CPU time and are left out of the chart
+    timelineWriter *timeline = context;
+    schedulerTimeSlice *open = &timeline->open[slice->cpu];
+    if (slice->startTime == slice->endTime)
+    {
+        return;
+    }
+    if (open->process == slice->process && open->endTime == slice->startTime)
+    {
+        open->endTime = slice->endTime;
+        return;
+    }
+    if (open->process != -1)
+    {
+        writeTimelineInterval(timeline, open);
+    }
+    *open = *slice;
+}
+void writeTimelineInterval(timelineWriter *timeline, const schedulerTimeSlice *interval)
+{
+    // In the trace events a unit of simulated time is shown as a microsecond
+    long long values[4];
+    values[0] = interval->cpu;
+    values[1] = interval->process + 1;
+    values[2] = interval->startTime;
+    values[3] = interval->endTime;
+    if (timeline->toTimeline)
+    {
+        ReportWriteRecord(&timeline->writer, values);
+    }
+    if (timeline->toEvents)
+    {
+        writeTraceEvent(&timeline->events, "Process-", interval->process + 1, 0, interval->cpu,
+                        interval->startTime * 1000LL, (interval->endTime - interval->startTime) * 1000LL, -1);
+    }
+}
+void closeTimeline(timelineWriter *timeline, const char *path, const char *eventsPath)
+{
+    // The trace events end with the engine phases of the run, kept only by a build with SCHEDULER_PROFILE
+    for (int c = 0; c < timeline->cpuCount; c++)
+    {
+        if (timeline->open[c].process != -1)
+        {
+            writeTimelineInterval(timeline, &timeline->open[c]);
+        }
+    }
+    free(timeline->open);
+    if (timeline->toTimeline)
+    {
+        closeReport(&timeline->writer, timeline->writer.fp, path);
+    }
+    if (timeline->toEvents)
+    {
+        schedulerProfile profile;
+        schedulerPhaseEvent event;
+        SchedulerGetProfile(&profile);
+        writeTraceMetadata(&timeline->events, "process_name", 1, 0, "Scheduler engine", -1);
+        for (long long i = 0; SchedulerGetPhaseEvent(i, &event) == SCHEDULER_OK; i++)
+        {
+            writeTraceEvent(&timeline->events, SchedulerPhaseName(event.phase), -1, 1, 0, event.startTime, event.duration, event.nodesVisited);
+        }
+        ReportWriteText(&timeline->events, "\n]\n");
+        closeReport(&timeline->events, timeline->events.fp, eventsPath);
+        if (!profile.enabled)
+        {
+            printf("Engine phases are only traced by a build with -DSCHEDULER_PROFILE\n");
+        }
+        else if (profile.droppedEvents > 0)
+        {
+            printf("Trace events hold the first %lli engine phases, %lli more were left out\n", profile.events, profile.droppedEvents);
+        }
+    }
+}
+void writeTraceEvent(reportWriter *writer, const char *name, int id, int pid, int tid, long long start, long long duration, long long nodesVisited)
+{
+    // Complete event of the chrome trace format, name followed by id unless it is -1, nodes visited unless -1
+    ReportWriteText(writer, writer->records == 0 ? "\n{\"name\":\"" : ",\n{\"name\":\"");
+    writer->records++;
+    ReportWriteText(writer, name);
+    if (id != -1)
+    {
+        ReportWriteInteger(writer, id);
+    }
+    ReportWriteText(writer, "\",\"ph\":\"X\",\"pid\":");
+    ReportWriteInteger(writer, pid);
+    ReportWriteText(writer, ",\"tid\":");
+    ReportWriteInteger(writer, tid);
+    ReportWriteText(writer, ",\"ts\":");
+    writeMicroseconds(writer, start);
+    ReportWriteText(writer, ",\"dur\":");
+    writeMicroseconds(writer, duration);
+    if (nodesVisited != -1)
+    {
+        ReportWriteText(writer, ",\"args\":{\"nodes visited\":");
+        ReportWriteInteger(writer, nodesVisited);
+        ReportWriteText(writer, "}");
+    }
+    ReportWriteText(writer, "}");
+}
+void writeTraceMetadata(reportWriter *writer, const char *kind, int pid, int tid, const char *name, int id)
+{
+    // Names a process or thread row of the trace viewer, name followed by id unless it is -1
+    ReportWriteText(writer, writer->records == 0 ? "\n{\"name\":\"" : ",\n{\"name\":\"");
+    writer->records++;
+    ReportWriteText(writer, kind);
+    ReportWriteText(writer, "\",\"ph\":\"M\",\"pid\":");
+    ReportWriteInteger(writer, pid);
+    ReportWriteText(writer, ",\"tid\":");
+    ReportWriteInteger(writer, tid);
+    ReportWriteText(writer, ",\"args\":{\"name\":\"");
+    ReportWriteText(writer, name);
+    if (id != -1)
+    {
+        ReportWriteInteger(writer, id);
+    }
+    ReportWriteText(writer, "\"}}");
+}
+void writeMicroseconds(reportWriter *writer, long long nanoseconds)
+{
+    // Trace event times are in microseconds, nanoseconds are kept as 3 decimals
+    ReportWriteInteger(writer, nanoseconds / 1000);
+    int fraction = (int)(nanoseconds % 1000);
+    if (fraction != 0)
+    {
+        char decimals[5] = {'.', (char)('0' + fraction / 100), (char)('0' + fraction / 10 % 10), (char)('0' + fraction % 10), '\0'};
+        ReportWriteText(writer, decimals);
+    }
+}
+void exitOnSchedulerError(schedulerStatus status)
+{
+    if (status != SCHEDULER_OK && status != SCHEDULER_FINISHED)
+    {
+        printf("%s\n", SchedulerStatusString(status));
+        exit(1);
+    }
+}
+void *allocateColumn(size_t count, size_t size)
+{
+    // Allocates a zeroed column on the heap, at least 1 entry so an empty input still gets a valid pointer
+    void *column = calloc(count > 0 ? count : 1, size);
+    if (column == NULL)
+    {
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+    return column;
+}
+void initTraceColumns(traceColumns *trace)
+{
+    trace->count = 0;
+    trace->capacity = TRACE_INITIAL_CAPACITY;
+    trace->arrivalTime = allocateColumn(trace->capacity, sizeof(int));
+    trace->burstTime = allocateColumn(trace->capacity, sizeof(int));
+    trace->priority = NULL;
+    trace->group = NULL;
+    trace->groupCount = 1;
+    trace->mappedTrace = NULL;
+    trace->mappedLength = 0;
+}
+void appendTraceRow(traceColumns *trace, int arrivalTime, int burstTime, int priority, int group)
+{
+    // Adds a row for a newly parsed process, doubling the columns when they are full
+    // The class columns are only allocated once a line gives a class other than 0, earlier rows are 0
+    if (trace->count == trace->capacity)
+    {
+        if (trace->capacity > INT_MAX / 2)
+        {
+            printf("Failed to allocate memory\n");
+            exit(1);
+        }
+        int *arrivalColumn = realloc(trace->arrivalTime, (size_t)trace->capacity * 2 * sizeof(int));
+        int *burstColumn = arrivalColumn == NULL ? NULL : realloc(trace->burstTime, (size_t)trace->capacity * 2 * sizeof(int));
+        if (burstColumn == NULL)
+        {
+            printf("Failed to allocate memory\n");
+            exit(1);
+        }
+        trace->arrivalTime = arrivalColumn;
+        trace->burstTime = burstColumn;
+        int **classColumns[2] = {&trace->priority, &trace->group};
+        for (int c = 0; c < 2; c++)
+        {
+            if (*classColumns[c] != NULL)
+            {
+                int *grown = realloc(*classColumns[c], (size_t)trace->capacity * 2 * sizeof(int));
+                if (grown == NULL)
+                {
+                    printf("Failed to allocate memory\n");
+                    exit(1);
+                }
+                *classColumns[c] = grown;
+            }
+        }
+        trace->capacity *= 2;
+    }
+    if (priority != 0 && trace->priority == NULL)
+    {
+        trace->priority = allocateColumn(trace->capacity, sizeof(int));
+    }
+    if (group != 0 && trace->group == NULL)
+    {
+        trace->group = allocateColumn(trace->capacity, sizeof(int));
+    }
+    trace->arrivalTime[trace->count] = arrivalTime;
+    trace->burstTime[trace->count] = burstTime;
+    if (trace->priority != NULL)
+    {
+        trace->priority[trace->count] = priority;
+    }
+    if (trace->group != NULL)
+    {
+        trace->group[trace->count] = group;
+    }
+    if (trace->groupCount <= group)
+    {
+        trace->groupCount = group + 1;
+    }
+    trace->count++;
+}
+void freeTraceColumns(traceColumns *trace)
+{
+    if (trace->mappedTrace != NULL)
+    {
+#ifdef TRACE_USE_MMAP
+        munmap(trace->mappedTrace, trace->mappedLength);
+#endif
+    }
+    else
+    {
+        free(trace->arrivalTime);
+        free(trace->burstTime);
+    }
+    free(trace->priority);
+    free(trace->group);
+}
+int readTraceFile(FILE *fp, traceColumns *trace)
+{
+    // Detects the trace format from its first bytes, which are handed to the text parser if they are not the binary magic
+    char magic[4];
+    size_t length = fread(magic, 1, sizeof(magic), fp);
+    if (length == sizeof(magic) && memcmp(magic, BINARY_TRACE_MAGIC, sizeof(magic)) == 0)
+    {
+        return loadBinaryTrace(fp, trace);
+    }
+    traceParser parser;
+    initTraceParser(&parser);
+    parser.trace = trace;
+    feedTraceParser(&parser, magic, length);
+    return parseTraceFile(fp, &parser);
+}
+int parseTraceFile(FILE *fp, traceParser *parser)
+{
+    // Reads the rest of a text trace once in large blocks and appends a row to the trace per line
+    // Input ends at the first empty line (as per specifications) or at the end of the file
+    char *block = allocateColumn(TRACE_READ_BLOCK_SIZE, sizeof(char));
+    size_t length;
+    while (!parser->finished && (length = fread(block, 1, TRACE_READ_BLOCK_SIZE, fp)) > 0)
+    {
+        feedTraceParser(parser, block, length);
+    }
+    if (!parser->finished)
+    {
+        endTraceLine(parser); // last line need not end with a newline
+    }
+    free(block);
+    return parser->trace->count;
+}
+void initTraceParser(traceParser *parser)
+{
+    parser->lineNumber = 1;
+    parser->field = 0;
+    parser->inToken = false;
+    parser->finished = false;
+    parser->value = 0;
+    parser->trace = NULL;
+    parser->online = NULL;
+}
+void feedTraceParser(traceParser *parser, const char *block, size_t length)
+{
+    // Each line holds arrival and burst time as positive integers separated by spaces or tabs,
+    // optionally followed by a priority class and a group, both 0 when left out
+    // Digits are accumulated straight into the value, so tokens of any length are checked against INT_MAX
+    for (size_t i = 0; i < length && !parser->finished; i++)
+    {
+        char c = block[i];
+        if (c >= '0' && c <= '9')
+        {
+            if (parser->field < 4)
+            {
+                parser->value = parser->value * 10 + (c - '0');
+                if (parser->value > INT_MAX)
+                {
+                    printf("Invalid input detected at line %d \n", parser->lineNumber);
+                    exit(0);
+                }
+            }
+            parser->inToken = true;
+        }
+        else if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            endTraceToken(parser);
+            if (c == '\n')
+            {
+                endTraceLine(parser);
+            }
+        }
+        else if (parser->field < 4)
+        {
+            // only positive integer values are accepted for arrival time, burst time, priority and group
+            printf("Invalid input detected at line %d \n", parser->lineNumber);
+            exit(0);
+        }
+        else
+        {
+            parser->inToken = true;
+        }
+    }
+}
+void endTraceToken(traceParser *parser)
+{
+    // Stores the token just read as arrival time, burst time, priority or group and moves on to the next field
+    if (parser->inToken)
+    {
+        if (parser->field < 4)
+        {
+            parser->values[parser->field] = (int)parser->value;
+        }
+        parser->field++;
+        parser->value = 0;
+        parser->inToken = false;
+    }
+}
+void endTraceLine(traceParser *parser)
+{
+    // Completes the current line, an empty line ends the input
+    endTraceToken(parser);
+    if (parser->field == 0)
+    {
+        parser->finished = true;
+        return;
+    }
+    if (parser->field < 2 || (parser->field > 2 && parser->values[2] >= SCHEDULER_PRIORITY_LEVELS) ||
+        (parser->field > 3 && parser->values[3] >= TRACE_MAX_GROUPS))
+    {
+        printf("Invalid input detected at line %d \n", parser->lineNumber);
+        exit(0);
+    }
+    if (parser->online != NULL)
+    {
+        schedulerStatus status = SchedulerAddJob(parser->online, parser->values[0], parser->values[1]);
+        if (status == SCHEDULER_ARRIVAL_OUT_OF_ORDER)
+        {
+            printf("Arrival time out of order at line %d \n", parser->lineNumber);
+            exit(0);
         }
+        exitOnSchedulerError(status);
+    }
+    else
+    {
+        appendTraceRow(parser->trace, parser->values[0], parser->values[1],
+                       parser->field > 2 ? parser->values[2] : 0, parser->field > 3 ? parser->values[3] : 0);
     }
-    printf("minimum waiting time: %.2f\n", minWaitTime);
-    return minWaitTime;
+    parser->field = 0;
+    parser->lineNumber++;
+}
+bool hostIsLittleEndian(void)
+{
+    unsigned int one = 1;
+    return *(unsigned char *)&one == 1;
+}
+unsigned int decodeUInt32(const unsigned char *bytes)
+{
+    return (unsigned int)bytes[0] | (unsigned int)bytes[1] << 8 | (unsigned int)bytes[2] << 16 | (unsigned int)bytes[3] << 24;
 }
+void encodeUInt32(unsigned char *bytes, unsigned int value)
+{
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = (value >> 16) & 0xFF;
+    bytes[3] = (value >> 24) & 0xFF;
+}
+int loadBinaryTrace(FILE *fp, traceColumns *trace)
+{
+    // Loads a binary trace whose magic has already been read from fp
+    // The arrival and burst columns are mapped in place when possible, otherwise they are read and decoded
+    unsigned char header[BINARY_TRACE_HEADER_SIZE - 4];
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header) || decodeUInt32(header) != BINARY_TRACE_VERSION)
+    {
+        printf("Invalid binary trace header \n");
+        exit(0);
+    }
+    unsigned long long count = decodeUInt32(header + 4) | (unsigned long long)decodeUInt32(header + 8) << 32;
+    if (count > INT_MAX)
+    {
+        printf("Invalid binary trace header \n");
+        exit(0);
+    }
+    int numberOfFiles = (int)count;
+    size_t columnBytes = (size_t)numberOfFiles * sizeof(int);
+
+#ifdef TRACE_USE_MMAP
+    struct stat status;
+    if (hostIsLittleEndian() && numberOfFiles > 0 && fstat(fileno(fp), &status) == 0 && S_ISREG(status.st_mode))
+    {
+        if ((unsigned long long)status.st_size != BINARY_TRACE_HEADER_SIZE + 2 * (unsigned long long)columnBytes)
+        {
+            printf("Invalid binary trace length \n");
+            exit(0);
+        }
+        void *mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+        if (mapped != MAP_FAILED)
+        {
+            // Swap the allocated columns for the mapped ones
+            free(trace->arrivalTime);
+            free(trace->burstTime);
+            trace->mappedTrace = mapped;
+            trace->mappedLength = status.st_size;
+            trace->arrivalTime = (int *)((char *)mapped + BINARY_TRACE_HEADER_SIZE);
+            trace->burstTime = (int *)((char *)mapped + BINARY_TRACE_HEADER_SIZE + columnBytes);
+            trace->capacity = numberOfFiles;
+            trace->count = numberOfFiles;
+        }
+    }
+#endif
+
+    if (trace->mappedTrace == NULL)
+    {
+        if (numberOfFiles > trace->capacity)
+        {
+            free(trace->arrivalTime);
+            free(trace->burstTime);
+            trace->arrivalTime = allocateColumn(numberOfFiles, sizeof(int));
+            trace->burstTime = allocateColumn(numberOfFiles, sizeof(int));
+            trace->capacity = numberOfFiles;
+        }
+        int *columns[2] = {trace->arrivalTime, trace->burstTime};
+        unsigned char *block = allocateColumn(TRACE_READ_BLOCK_SIZE, sizeof(char));
+        for (int c = 0; c < 2; c++)
+        {
+            int row = 0;
+            while (row < numberOfFiles)
+            {
+                size_t rows = numberOfFiles - row;
+                if (rows > TRACE_READ_BLOCK_SIZE / 4)
+                {
+                    rows = TRACE_READ_BLOCK_SIZE / 4;
+                }
+                if (fread(block, 4, rows, fp) != rows)
+                {
+                    printf("Invalid binary trace length \n");
+                    exit(0);
+                }
+                for (size_t r = 0; r < rows; r++)
+                {
+                    columns[c][row + r] = (int)decodeUInt32(block + 4 * r);
+                }
+                row += rows;
+            }
+        }
+        free(block);
+        trace->count = numberOfFiles;
+    }
 
-float GetMaxTurnAroundTime(fileAttribute completedFileTable[], int numberOfFiles) {
-    float maxTurn = completedFileTable[0].turnAroundTime;
-    for (int i = 1; i < numberOfFiles; i++){
-        if (maxTurn < completedFileTable[i].turnAroundTime) {
-            maxTurn = completedFileTable[i].turnAroundTime;
+    // Same checks as the text parser, arrival and burst time must be positive integer values
+    for (int i = 0; i < numberOfFiles; i++)
+    {
+        if (trace->arrivalTime[i] < 0 || trace->burstTime[i] < 0)
+        {
+            printf("Invalid input detected at process %d \n", i + 1);
+            exit(0);
         }
     }
-    printf("maximum turnaround time: %.2f\n", maxTurn);
-    return maxTurn;
+    return numberOfFiles;
 }
+void writeBinaryTrace(FILE *fp, traceColumns *trace)
+{
+    // Writes the header followed by the arrival and burst columns, encoded a block at a time
+    unsigned char header[BINARY_TRACE_HEADER_SIZE];
+    memcpy(header, BINARY_TRACE_MAGIC, 4);
+    encodeUInt32(header + 4, BINARY_TRACE_VERSION);
+    encodeUInt32(header + 8, (unsigned int)trace->count);
+    encodeUInt32(header + 12, 0);
+    fwrite(header, 1, sizeof(header), fp);
 
-float GetMinTurnAroundTime(fileAttribute completedFileTable[], int numberOfFiles) {
-    float minTurn = completedFileTable[0].turnAroundTime;
-    for (int i = 1; i < numberOfFiles; i++){
-        if (minTurn> completedFileTable[i].turnAroundTime) {
-            minTurn= completedFileTable[i].turnAroundTime;
+    int *columns[2] = {trace->arrivalTime, trace->burstTime};
+    unsigned char *block = allocateColumn(TRACE_READ_BLOCK_SIZE, sizeof(char));
+    for (int c = 0; c < 2; c++)
+    {
+        int row = 0;
+        while (row < trace->count)
+        {
+            size_t rows = trace->count - row;
+            if (rows > TRACE_READ_BLOCK_SIZE / 4)
+            {
+                rows = TRACE_READ_BLOCK_SIZE / 4;
+            }
+            for (size_t r = 0; r < rows; r++)
+            {
+                encodeUInt32(block + 4 * r, (unsigned int)columns[c][row + r]);
+            }
+            fwrite(block, 4, rows, fp);
+            row += rows;
+        }
+    }
+    free(block);
+}
+void writeTextTrace(FILE *fp, traceColumns *trace)
+{
+    // Same layout as the files in Test Cases, one arrival<TAB>burst pair per line, then priority and group if given
+    for (int i = 0; i < trace->count; i++)
+    {
+        if (trace->priority != NULL || trace->group != NULL)
+        {
+            fprintf(fp, "%d\t%d\t%d\t%d\n", trace->arrivalTime[i], trace->burstTime[i],
+                    trace->priority != NULL ? trace->priority[i] : 0, trace->group != NULL ? trace->group[i] : 0);
+        }
+        else
+        {
+            fprintf(fp, "%d\t%d\n", trace->arrivalTime[i], trace->burstTime[i]);
         }
     }
-    printf("minimum turnaround time: %.2f\n", minTurn);
-    return minTurn;
+}
+void convertTraceFile(const char *mode, const char *inputPath, const char *outputPath)
+{
+    // Reads a trace in either format and writes it out as binary (--to-binary) or text (--to-text)
+    FILE *input = fopen(inputPath, "rb");
+    if (input == NULL)
+    {
+        printf("<%s> does not exist!\n", inputPath);
+        exit(1);
+    }
+    traceColumns trace;
+    initTraceColumns(&trace);
+    readTraceFile(input, &trace);
+    fclose(input);
+    if (strcmp(mode, "--to-binary") == 0 && (trace.priority != NULL || trace.group != NULL))
+    {
+        printf("<%s> has priority or group columns, binary traces hold arrival and burst time only\n", inputPath);
+        exit(1);
+    }
+
+    FILE *output = fopen(outputPath, "wb");
+    if (output == NULL)
+    {
+        printf("<%s> could not be created!\n", outputPath);
+        exit(1);
+    }
+    if (strcmp(mode, "--to-binary") == 0)
+    {
+        writeBinaryTrace(output, &trace);
+    }
+    else
+    {
+        writeTextTrace(output, &trace);
+    }
+    if (ferror(output) || fclose(output) != 0)
+    {
+        printf("Failed to write <%s>\n", outputPath);
+        exit(1);
+    }
+    freeTraceColumns(&trace);
 }
 
-void printOrderOfCompletion(fileAttribute completedFileTable[], int numberOfFiles) {
+// Functions that print average or max/min turnaround and waiting times
+void printResults(schedulerResults *results)
+{
+    printf("average turnaround time: %.2f\n", results->averageTurnaroundTime);
+    printf("maximum turnaround time: %.2f\n", results->maxTurnaroundTime);
+    printf("average waiting time: %.2f\n", results->averageWaitingTime);
+    printf("maximum waiting time: %.2f\n", results->maxWaitingTime);
+    printf("minimum waiting time: %.2f\n", results->minWaitingTime);
+    printf("minimum turnaround time: %.2f\n", results->minTurnaroundTime);
+}
+
+void printOrderOfCompletion(scheduler *s) {
     // prints sequence in which processes were completed
-    printf("Order of completion: ");
-    for (int i = 0; i < numberOfFiles; i++) {
-        printf("[Process-%i]", completedFileTable[i].fileID + 1);
-        if (i != numberOfFiles - 1) {
-            printf(" -> ");
+    // formatted through the report buffer, the line grows with the trace and would be one printf per process
+    int count = SchedulerGetCompletedCount(s);
+    schedulerCompletion completion;
+    reportWriter writer;
+    if (!ReportWriterOpen(&writer, stdout, REPORT_CSV, NULL, 0))
+    {
+        printf("Failed to allocate memory\n");
+        exit(1);
+    }
+    ReportWriteText(&writer, "Order of completion: ");
+    for (int i = 0; i < count; i++) {
+        SchedulerGetCompletion(s, i, &completion);
+        ReportWriteText(&writer, "[Process-");
+        ReportWriteInteger(&writer, completion.process + 1);
+        ReportWriteText(&writer, "]");
+        if (i != count - 1) {
+            ReportWriteText(&writer, " -> ");
+        }
+    }
+    ReportWriteText(&writer, "\n");
+    ReportWriterClose(&writer);
+}
+
+void printPercentiles(scheduler *s)
+{
+    // Tail percentiles from the fixed size histograms, exact below 16 and within 1/8 above
+    const char *names[SCHEDULER_METRIC_COUNT] = {"waiting time", "turnaround time", "response time"};
+    schedulerHistogram histogram;
+    for (int metric = 0; metric < SCHEDULER_METRIC_COUNT; metric++)
+    {
+        SchedulerGetHistogram(s, metric, &histogram);
+        printf("%s percentiles: p50: %i, p90: %i, p99: %i, p99.9: %i\n", names[metric],
+               SchedulerHistogramPercentile(&histogram, 50.0), SchedulerHistogramPercentile(&histogram, 90.0),
+               SchedulerHistogramPercentile(&histogram, 99.0), SchedulerHistogramPercentile(&histogram, 99.9));
+    }
+}
+
+void printContextSwitches(schedulerResults *results)
+{
+    printf("context switches: %lli\n", results->contextSwitches);
+    printf("preemptions: %lli\n", results->preemptions);
+    printf("context switch time: %lli\n", results->switchTime);
+    printf("average dispatches per process: %.2f\n", results->averageDispatches);
+    printf("maximum dispatches per process: %i\n", results->maxDispatches);
+}
+
+void printCpuStats(scheduler *s)
+{
+    // Per CPU utilization, context switch time, migrations (processes stolen from other CPUs) and completions
+    schedulerCpuStats stats;
+    for (int c = 0; c < SchedulerGetCpuCount(s); c++)
+    {
+        SchedulerGetCpuStats(s, c, &stats);
+        printf("CPU %i: utilization: %.2f%%, context switch time: %lli, migrations: %i, completed: %i\n",
+               c, stats.utilization * 100, stats.switchTime, stats.migrations, stats.completed);
+    }
+}
+
+void printClassStats(scheduler *s)
+{
+    // Wait and turnaround per priority class (those with processes) and per group, service time is the CPU time received
+    schedulerClassStats stats;
+    for (int priority = 0; priority < SCHEDULER_PRIORITY_LEVELS; priority++)
+    {
+        SchedulerGetPriorityStats(s, priority, &stats);
+        if (stats.completed > 0)
+        {
+            printf("priority %i: completed: %i, average waiting time: %.2f, maximum waiting time: %i, average turnaround time: %.2f, maximum turnaround time: %i, service time: %lli\n",
+                   priority, stats.completed, stats.averageWaitingTime, stats.maxWaitingTime, stats.averageTurnaroundTime, stats.maxTurnaroundTime, stats.serviceTime);
         }
     }
-    printf("\n");
+    for (int group = 0; SchedulerGetGroupStats(s, group, &stats) == SCHEDULER_OK; group++)
+    {
+        printf("group %i: completed: %i, average waiting time: %.2f, maximum waiting time: %i, average turnaround time: %.2f, maximum turnaround time: %i, service time: %lli\n",
+               group, stats.completed, stats.averageWaitingTime, stats.maxWaitingTime, stats.averageTurnaroundTime, stats.maxTurnaroundTime, stats.serviceTime);
+    }
 }
 
-void freeAllocatedMemory(readyQueueNode *readyQueue) {
-    // Frees memory allocated for linked list (ReadyQueue)
-    readyQueueNode *tmp = NULL;
-    while (readyQueue != NULL) {
-        tmp = readyQueue;
-        readyQueue = readyQueue->next;
-        free(tmp);
+void printProfile(void)
+{
+    // Calls, nodes visited and time per engine phase, times include the phases nested in them
+    schedulerProfile profile;
+    SchedulerGetProfile(&profile);
+    if (!profile.enabled)
+    {
+        printf("Engine phases are only measured by a build with -DSCHEDULER_PROFILE\n");
+        return;
+    }
+    for (int phase = 0; phase < SCHEDULER_PHASE_COUNT; phase++)
+    {
+        const schedulerPhaseStats *stats = &profile.phases[phase];
+        printf("%s: calls: %lli, nodes visited: %lli, time: %.3f ms, %.1f ns per call\n",
+               SchedulerPhaseName((schedulerPhase)phase), stats->calls, stats->nodesVisited, stats->nanoseconds / 1e6,
+               stats->calls > 0 ? (double)stats->nanoseconds / stats->calls : 0.0);
     }
 }
@@ -0,0 +1,162 @@
+#include <limits.h>
+#include "reduce.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define REDUCE_X86 1 // SIMD kernels compiled in, chosen at run time by what the CPU supports
+#endif
+
+#define REDUCE_SSE_LANES 4  // ints per SSE4.1 vector
+#define REDUCE_AVX2_LANES 8 // ints per AVX2 vector
+
+static void reduceScalar(const int *values, int start, int count, columnReduction *reduction);
+static void mergeLane(columnReduction *reduction, long long sum, int min, int max, int argmin);
+#ifdef REDUCE_X86
+static int reduceSse41(const int *values, int count, columnReduction *reduction);
+static int reduceAvx2(const int *values, int count, columnReduction *reduction);
+#endif
+
+void ReduceColumn(const int *values, int count, columnReduction *reduction)
+{
+    // Whole vectors go through the widest kernel the CPU has, the rows left over through the scalar loop
+    // min and max are 0 for an empty column
+    reduction->sum = 0;
+    reduction->min = INT_MAX;
+    reduction->max = INT_MIN;
+    reduction->argmin = -1;
+    int done = 0;
+#ifdef REDUCE_X86
+    if (count >= REDUCE_AVX2_LANES && __builtin_cpu_supports("avx2"))
+    {
+        done = reduceAvx2(values, count, reduction);
+    }
+    else if (count >= REDUCE_SSE_LANES && __builtin_cpu_supports("sse4.1"))
+    {
+        done = reduceSse41(values, count, reduction);
+    }
+#endif
+    reduceScalar(values, done, count, reduction);
+    if (count <= 0)
+    {
+        reduction->min = 0;
+        reduction->max = 0;
+    }
+}
+
+static void reduceScalar(const int *values, int start, int count, columnReduction *reduction)
+{
+    // Folds rows start to count - 1 into reduction, the rows before start are already in it
+    for (int i = start; i < count; i++)
+    {
+        reduction->sum += values[i];
+        if (reduction->argmin == -1 || values[i] < reduction->min)
+        {
+            reduction->min = values[i];
+            reduction->argmin = i;
+        }
+        if (values[i] > reduction->max)
+        {
+            reduction->max = values[i];
+        }
+    }
+}
+
+static void mergeLane(columnReduction *reduction, long long sum, int min, int max, int argmin)
+{
+    // Adds the partial result of one vector lane, an equal minimum goes to the earlier row
+    reduction->sum += sum;
+    if (reduction->argmin == -1 || min < reduction->min || (min == reduction->min && argmin < reduction->argmin))
+    {
+        reduction->min = min;
+        reduction->argmin = argmin;
+    }
+    if (max > reduction->max)
+    {
+        reduction->max = max;
+    }
+}
+
+#ifdef REDUCE_X86
+__attribute__((target("sse4.1")))
+static int reduceSse41(const int *values, int count, columnReduction *reduction)
+{
+    // Each lane keeps its own sum (as two 64-bit halves), minimum, maximum and the first row of its minimum
+    // Lanes start from the first vector, so a lane always holds a row; returns the rows reduced
+    int rows = count - count % REDUCE_SSE_LANES;
+    __m128i first = _mm_loadu_si128((const __m128i *)values);
+    __m128i sumLow = _mm_cvtepi32_epi64(first);
+    __m128i sumHigh = _mm_cvtepi32_epi64(_mm_srli_si128(first, 8));
+    __m128i minimum = first;
+    __m128i maximum = first;
+    __m128i row = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i minRow = row;
+    __m128i step = _mm_set1_epi32(REDUCE_SSE_LANES);
+    for (int i = REDUCE_SSE_LANES; i < rows; i += REDUCE_SSE_LANES)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i *)(values + i));
+        row = _mm_add_epi32(row, step);
+        sumLow = _mm_add_epi64(sumLow, _mm_cvtepi32_epi64(value));
+        sumHigh = _mm_add_epi64(sumHigh, _mm_cvtepi32_epi64(_mm_srli_si128(value, 8)));
+        __m128i lower = _mm_cmpgt_epi32(minimum, value); // strictly lower, an equal value keeps the earlier row
+        minRow = _mm_blendv_epi8(minRow, row, lower);
+        minimum = _mm_min_epi32(minimum, value);
+        maximum = _mm_max_epi32(maximum, value);
+    }
+
+    long long sums[REDUCE_SSE_LANES];
+    int mins[REDUCE_SSE_LANES];
+    int maxs[REDUCE_SSE_LANES];
+    int minRows[REDUCE_SSE_LANES];
+    _mm_storeu_si128((__m128i *)sums, sumLow);
+    _mm_storeu_si128((__m128i *)(sums + 2), sumHigh);
+    _mm_storeu_si128((__m128i *)mins, minimum);
+    _mm_storeu_si128((__m128i *)maxs, maximum);
+    _mm_storeu_si128((__m128i *)minRows, minRow);
+    for (int lane = 0; lane < REDUCE_SSE_LANES; lane++)
+    {
+        mergeLane(reduction, sums[lane], mins[lane], maxs[lane], minRows[lane]);
+    }
+    return rows;
+}
+
+__attribute__((target("avx2")))
+static int reduceAvx2(const int *values, int count, columnReduction *reduction)
+{
+    // Same as reduceSse41 with 8 lanes, the sums of lanes 0-3 and 4-7 are widened from each 128-bit half
+    int rows = count - count % REDUCE_AVX2_LANES;
+    __m256i first = _mm256_loadu_si256((const __m256i *)values);
+    __m256i sumLow = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(first));
+    __m256i sumHigh = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(first, 1));
+    __m256i minimum = first;
+    __m256i maximum = first;
+    __m256i row = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i minRow = row;
+    __m256i step = _mm256_set1_epi32(REDUCE_AVX2_LANES);
+    for (int i = REDUCE_AVX2_LANES; i < rows; i += REDUCE_AVX2_LANES)
+    {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(values + i));
+        row = _mm256_add_epi32(row, step);
+        sumLow = _mm256_add_epi64(sumLow, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(value)));
+        sumHigh = _mm256_add_epi64(sumHigh, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(value, 1)));
+        __m256i lower = _mm256_cmpgt_epi32(minimum, value);
+        minRow = _mm256_blendv_epi8(minRow, row, lower);
+        minimum = _mm256_min_epi32(minimum, value);
+        maximum = _mm256_max_epi32(maximum, value);
+    }
+
+    long long sums[REDUCE_AVX2_LANES];
+    int mins[REDUCE_AVX2_LANES];
+    int maxs[REDUCE_AVX2_LANES];
+    int minRows[REDUCE_AVX2_LANES];
+    _mm256_storeu_si256((__m256i *)sums, sumLow);
+    _mm256_storeu_si256((__m256i *)(sums + 4), sumHigh);
+    _mm256_storeu_si256((__m256i *)mins, minimum);
+    _mm256_storeu_si256((__m256i *)maxs, maximum);
+    _mm256_storeu_si256((__m256i *)minRows, minRow);
+    for (int lane = 0; lane < REDUCE_AVX2_LANES; lane++)
+    {
+        mergeLane(reduction, sums[lane], mins[lane], maxs[lane], minRows[lane]);
+    }
+    return rows;
+}
+#endif
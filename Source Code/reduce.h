@@ -0,0 +1,21 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+/*
+Fused reduction over a contiguous int column: sum, minimum, maximum and the first row holding the minimum,
+in a single pass. The sum is exact, every value is widened to 64 bits before it is added.
+On x86 built with GCC or Clang the AVX2 or SSE4.1 kernel is picked at run time when the CPU has it,
+a scalar loop otherwise; every kernel gives the same result.
+*/
+
+typedef struct columnReduction
+{
+    long long sum;
+    int min;
+    int max;
+    int argmin; // first row holding min, i.e., ties go to the earliest row (FIFO), -1 for an empty column
+} columnReduction;
+
+void ReduceColumn(const int *values, int count, columnReduction *reduction);
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include "reference.h"
+
+static int pickReferenceProcess(const int *arrivalTime, const int *remaining, const bool *completed, int count, int timeElapsed, int *readyCount);
+
+bool ReferenceSchedule(const int *arrivalTime, const int *burstTime, int count, int timeQuantum, schedulerCompletion *completions)
+{
+    // Fills completions in order of completion, false if out of memory
+    // At every decision point (the CPU is idle or a time slice has ended) every arrived, uncompleted process is ready:
+    // >> only 1 ready: it runs for the time quantum, or less to completion (RR)
+    // >> more than 1 ready: the one with the lowest remaining burst time runs to completion (SJF),
+    //    ties go to the lowest arrival time, then to the order of the trace (FIFO)
+    int *remaining = malloc((count > 0 ? count : 1) * sizeof(int));
+    int *responseTime = malloc((count > 0 ? count : 1) * sizeof(int));
+    bool *completed = calloc(count > 0 ? count : 1, sizeof(bool));
+    if (remaining == NULL || responseTime == NULL || completed == NULL)
+    {
+        free(remaining);
+        free(responseTime);
+        free(completed);
+        return false;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        remaining[i] = burstTime[i];
+        responseTime[i] = -1;
+    }
+
+    int timeElapsed = 0;
+    int done = 0;
+    int running = -1;
+    int sliceLeft = 0;
+    while (done < count)
+    {
+        if (running == -1 || sliceLeft == 0)
+        {
+            int readyCount;
+            running = pickReferenceProcess(arrivalTime, remaining, completed, count, timeElapsed, &readyCount);
+            if (running == -1)
+            {
+                timeElapsed++; // idle
+                continue;
+            }
+            sliceLeft = readyCount == 1 && timeQuantum < remaining[running] ? timeQuantum : remaining[running];
+            if (responseTime[running] == -1)
+            {
+                responseTime[running] = timeElapsed - arrivalTime[running];
+            }
+        }
+        if (sliceLeft > 0)
+        {
+            remaining[running]--;
+            sliceLeft--;
+            timeElapsed++;
+        }
+        if (remaining[running] == 0)
+        {
+            schedulerCompletion *completion = &completions[done];
+            completion->process = running;
+            completion->arrivalTime = arrivalTime[running];
+            completion->burstTime = burstTime[running];
+            completion->completionTime = timeElapsed;
+            completion->turnAroundTime = timeElapsed - arrivalTime[running];
+            completion->waitingTime = completion->turnAroundTime - burstTime[running];
+            completion->responseTime = responseTime[running];
+            completion->dispatches = 0; // not modelled
+            completed[running] = true;
+            done++;
+            running = -1;
+        }
+    }
+    free(remaining);
+    free(responseTime);
+    free(completed);
+    return true;
+}
+
+static int pickReferenceProcess(const int *arrivalTime, const int *remaining, const bool *completed, int count, int timeElapsed, int *readyCount)
+{
+    // Lowest (remaining burst time, arrival time, trace order) of the ready processes, -1 if there are none
+    int best = -1;
+    *readyCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (completed[i] || arrivalTime[i] > timeElapsed)
+        {
+            continue;
+        }
+        (*readyCount)++;
+        if (best == -1 || remaining[i] < remaining[best] ||
+            (remaining[i] == remaining[best] && arrivalTime[i] < arrivalTime[best]))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,15 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <stdbool.h>
+#include "scheduler.h"
+
+/*
+Slow reference of the documented Hybrid RR + SJF rules (one CPU, no context switch cost), for differential checking
+of the scheduler. Written for obviousness rather than speed: time advances one unit at a time and every decision
+scans every process, O(total time * processes).
+*/
+
+bool ReferenceSchedule(const int *arrivalTime, const int *burstTime, int count, int timeQuantum, schedulerCompletion *completions);
+
+#endif
@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <string.h>
+#include "report.h"
+
+static void reserveReportBuffer(reportWriter *writer, size_t length);
+static void flushReportBuffer(reportWriter *writer);
+
+reportFormat ReportFormatFromPath(const char *path)
+{
+    // JSON for a .json file name, CSV otherwise
+    size_t length = strlen(path);
+    if (length >= 5 && strcmp(path + length - 5, ".json") == 0)
+    {
+        return REPORT_JSON;
+    }
+    return REPORT_CSV;
+}
+
+bool ReportWriterOpen(reportWriter *writer, FILE *fp, reportFormat format, const char *const *fields, int fieldCount)
+{
+    // Starts the output, the CSV header or the opening bracket of the JSON array, false if out of memory
+    writer->fp = fp;
+    writer->format = format;
+    writer->fields = fields;
+    writer->fieldCount = fieldCount;
+    writer->used = 0;
+    writer->records = 0;
+    writer->failed = false;
+    writer->buffer = malloc(REPORT_BUFFER_SIZE);
+    if (writer->buffer == NULL)
+    {
+        writer->failed = true;
+        return false;
+    }
+    if (fieldCount == 0)
+    {
+        return true; // plain text through ReportWriteText / ReportWriteInteger
+    }
+    if (format == REPORT_JSON)
+    {
+        ReportWriteText(writer, "[");
+        return true;
+    }
+    for (int i = 0; i < fieldCount; i++)
+    {
+        ReportWriteText(writer, i == 0 ? "" : ",");
+        ReportWriteText(writer, fields[i]);
+    }
+    ReportWriteText(writer, "\n");
+    return true;
+}
+
+void ReportWriteRecord(reportWriter *writer, const long long *values)
+{
+    // One record, values[i] belongs to fields[i]
+    if (writer->format == REPORT_JSON)
+    {
+        ReportWriteText(writer, writer->records == 0 ? "\n{" : ",\n{");
+        for (int i = 0; i < writer->fieldCount; i++)
+        {
+            ReportWriteText(writer, i == 0 ? "\"" : ",\"");
+            ReportWriteText(writer, writer->fields[i]);
+            ReportWriteText(writer, "\":");
+            ReportWriteInteger(writer, values[i]);
+        }
+        ReportWriteText(writer, "}");
+    }
+    else
+    {
+        for (int i = 0; i < writer->fieldCount; i++)
+        {
+            if (i > 0)
+            {
+                ReportWriteText(writer, ",");
+            }
+            ReportWriteInteger(writer, values[i]);
+        }
+        ReportWriteText(writer, "\n");
+    }
+    writer->records++;
+}
+
+void ReportWriteText(reportWriter *writer, const char *text)
+{
+    size_t length = strlen(text);
+    while (length > 0 && !writer->failed)
+    {
+        // Text longer than the buffer is copied in buffer sized pieces
+        size_t piece = length < REPORT_BUFFER_SIZE ? length : REPORT_BUFFER_SIZE;
+        reserveReportBuffer(writer, piece);
+        if (writer->failed)
+        {
+            return;
+        }
+        memcpy(writer->buffer + writer->used, text, piece);
+        writer->used += piece;
+        text += piece;
+        length -= piece;
+    }
+}
+
+void ReportWriteInteger(reportWriter *writer, long long value)
+{
+    // Formats the digits in place, least significant first then reversed
+    char digits[24];
+    int count = 0;
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do
+    {
+        digits[count] = (char)('0' + magnitude % 10);
+        count++;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+    {
+        digits[count] = '-';
+        count++;
+    }
+    reserveReportBuffer(writer, count);
+    if (writer->failed)
+    {
+        return;
+    }
+    for (int i = count - 1; i >= 0; i--)
+    {
+        writer->buffer[writer->used] = digits[i];
+        writer->used++;
+    }
+}
+
+bool ReportWriterClose(reportWriter *writer)
+{
+    // Ends the JSON array and writes out what is left in the buffer, false if anything was lost
+    if (writer->fieldCount > 0 && writer->format == REPORT_JSON)
+    {
+        ReportWriteText(writer, writer->records == 0 ? "]\n" : "\n]\n");
+    }
+    flushReportBuffer(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+    return !writer->failed;
+}
+
+static void reserveReportBuffer(reportWriter *writer, size_t length)
+{
+    // Makes room for length more bytes (at most REPORT_BUFFER_SIZE) by writing the buffer out if needed
+    if (!writer->failed && writer->used + length > REPORT_BUFFER_SIZE)
+    {
+        flushReportBuffer(writer);
+    }
+}
+
+static void flushReportBuffer(reportWriter *writer)
+{
+    if (writer->failed || writer->used == 0)
+    {
+        return;
+    }
+    if (fwrite(writer->buffer, 1, writer->used, writer->fp) != writer->used)
+    {
+        writer->failed = true;
+    }
+    writer->used = 0;
+}
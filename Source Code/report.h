@@ -0,0 +1,43 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/*
+Buffered writer for machine readable results, records of integer fields as CSV or JSON.
+Everything is formatted into one large buffer that is handed to fwrite when full, there are no
+per-field stdio calls, so writing millions of records costs little more than the bytes themselves.
+
+CSV:  a header line with the field names, then one line per record
+JSON: an array with one object per record, e.g., [{"id":1,"arrival":0}, ...]
+*/
+
+#define REPORT_BUFFER_SIZE (1 << 20) // bytes formatted before they are written out
+
+typedef enum reportFormat
+{
+    REPORT_CSV = 0,
+    REPORT_JSON
+} reportFormat;
+
+typedef struct reportWriter
+{
+    FILE *fp;
+    reportFormat format;
+    const char *const *fields; // names of the fields of every record, must outlive the writer
+    int fieldCount;
+    char *buffer;
+    size_t used;
+    long long records;         // records written so far
+    bool failed;               // out of memory or a write failed, further output is dropped
+} reportWriter;
+
+reportFormat ReportFormatFromPath(const char *path);
+bool ReportWriterOpen(reportWriter *writer, FILE *fp, reportFormat format, const char *const *fields, int fieldCount);
+void ReportWriteRecord(reportWriter *writer, const long long *values);
+void ReportWriteText(reportWriter *writer, const char *text);
+void ReportWriteInteger(reportWriter *writer, long long value);
+bool ReportWriterClose(reportWriter *writer);
+
+#endif
@@ -0,0 +1,3111 @@
+#ifdef SCHEDULER_PROFILE
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#ifdef SCHEDULER_PROFILE
+#include <time.h>
+#endif
+#include "scheduler.h"
+#include "reduce.h"
+
+/*
+Process / File scheduler implements round robin (RR) with dynamic time quantums & shortest job first approach (SJF).
+State of one simulation is held in a scheduler context, functions other than the Scheduler* API are internal (static).
+Allocation failures are reported as SCHEDULER_OUT_OF_MEMORY, after one the context may only be destroyed.
+*/
+
+#define READY_QUEUE_SLAB_SIZE 1024      // nodes allocated at once by the ready queue node pool
+#define FLAG_WORD_BITS 64               // flags packed per flagWord of a bitset
+#define JOB_TABLE_INITIAL_CAPACITY 1024 // rows allocated before the job table first has to grow
+#define MLFQ_LEVELS 3                   // levels of the multilevel feedback queue, time quantum doubles per level
+#define HISTOGRAM_EXACT_BUCKETS 16      // times below this get a histogram bucket of their own
+#define HISTOGRAM_BUCKETS_PER_POWER 8   // histogram buckets per power of two above HISTOGRAM_EXACT_BUCKETS
+#define MAX_ADAPTIVE_TIME_QUANTUM (INT_MAX >> MLFQ_LEVELS) // MLFQ doubles the time quantum per level
+#define SNAPSHOT_MAGIC "HRRS"           // first bytes of a snapshot file
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304  // read back differently on a host of the other byte order
+#define SNAPSHOT_JOB_COLUMNS 11         // int columns of the job table in a snapshot
+#define SNAPSHOT_COMPLETED_COLUMNS 8    // int columns of the completed table in a snapshot
+#define PROFILE_MAX_EVENTS (1 << 20)    // phase events kept per thread, later ones are only counted
+
+typedef unsigned long long flagWord;
+
+typedef struct jobTable
+{
+    // Attributes of every process stored as columns (structure of arrays) on the heap, indexed by fileID
+    // Scans only pull in the columns they read, flags are packed into bitsets
+    int count;
+    int capacity;         // rows allocated in every column, grows as processes are added
+    int added;            // processes ever appended, rows of completed processes are reused
+    int *sequence;        // position of the process in order of adding, printed as Process-(sequence + 1)
+    int *arrivalTime;     // time process enters ready state
+    int *burstTime;       // time required for process
+    int *backUpBurstTime; // remaining burst time, when 0, process is deemed to have completed
+    int *waitingTime;     // total time process is in ready state, settled each time it is dispatched
+    int *responseTime;    // time process gets passed to CPU
+    int *readySince;      // time process last entered ready state (arrival or preemption)
+    int *queueLevel;      // MLFQ level, 0 is the highest priority
+    int *dispatchCount;   // times a CPU switched to the process
+    int *priority;        // priority class, 0 is the highest
+    int *group;           // group the process belongs to, e.g., a tenant
+
+    flagWord *hasArrived;   // if time-elapsed, file/proceess deemed to have arrived
+    flagWord *hasCompleted; // ignore once completed
+    flagWord *inQueue;      // if its in the ready queue
+
+    bool borrowedColumns; // arrivalTime and burstTime belong to the caller (SchedulerAddJobColumns), copied before any write
+
+    int *freeRows;        // rows released by completed processes, reused before the table grows
+    int freeCount;
+} jobTable;
+// Columns increase modularity and allow other aspects of file to be stored as further columns
+// e.g., priority, group (above), type etc.
+
+typedef struct completedTable
+{
+    // Computed times of completed processes, row i is the i-th process to complete
+    // only kept with schedulerOptions.retainCompletions
+    int count;
+    int capacity;
+    int *fileID;          // sequence of the process
+    int *waitingTime;
+    int *turnAroundTime;
+    int *responseTime;
+    int *completionTime;
+    int *dispatches;
+    int *priority;
+    int *group;
+} completedTable;
+
+typedef struct readyQueueNode
+{
+    // ready queue implemented as a linked list
+    int fileID; // row of the process in jobTable
+    struct readyQueueNode *next;
+    struct readyQueueNode *prev;
+    int heapIndex; // position within readyQueueHeap, -1 once completed
+    // Fair share: ready processes of a class in the order they became ready, the oldest is the first to age
+    struct readyQueueNode *olderNext;
+    struct readyQueueNode *olderPrev;
+    bool waiting; // linked into the waiting order of its class, i.e., ready and not holding the CPU
+} readyQueueNode;
+
+typedef struct readyQueueSlab
+{
+    // block of nodes handed out by the ready queue node pool
+    struct readyQueueSlab *next;
+    readyQueueNode nodes[READY_QUEUE_SLAB_SIZE];
+} readyQueueSlab;
+
+typedef struct readyQueueList
+{
+    // ready queue holds processes that have arrived and not completed
+    // nodes come from slabs, nodes of completed processes are unlinked and reused through freeNodes
+    readyQueueNode *head;
+    readyQueueNode *tail;
+    readyQueueNode *freeNodes;
+    readyQueueSlab *slabs;
+    int slabNodesUsed; // nodes handed out from the newest slab, freeNodes are reused first
+    int processesAdded; // total processes ever added to the queue
+
+    // live counts updated on admit / dispatch / complete, read through the Get*ProcessCount functions
+    readyQueueNode *runningNode; // process given the last time slice, NULL once it completes
+    int readyCount;     // arrived processes waiting for the CPU
+    int runningCount;   // 1 while runningNode is set
+    int completedCount; // processes completed and removed from the queue
+} readyQueueList;
+
+typedef struct readyQueueHeap
+{
+    // indexed binary min-heap over uncompleted nodes of the ready queue
+    // ordered by the policy, e.g., (remaining burst time, arrival time, fid), so nodes[0] is always the next pick
+    readyQueueNode **nodes;
+    int size;
+    int capacity;
+    jobTable *jobs; // columns the ordering is read from
+    const struct schedulingPolicy *policy; // ordering, see isLower
+} readyQueueHeap;
+
+typedef struct classQueue
+{
+    // Fair share: the processes of one (group, priority class) on one CPU
+    readyQueueHeap heap;     // hybrid RR + SJF order within the class
+    readyQueueNode *oldest;  // waiting processes by the time they became ready
+    readyQueueNode *newest;
+} classQueue;
+
+typedef struct cpuState
+{
+    // One simulated CPU, owns a ready queue and the heap over it
+    // A process holds the CPU for a whole time slice, which is accounted for once it ends
+    readyQueueList readyQueue;
+    readyQueueHeap heap;
+    readyQueueNode *slice; // process given the current time slice, NULL while the CPU is idle
+    int sliceLength;
+    int sliceEnd;          // time the current time slice ends
+    int sliceDispatched;   // time the current time slice was decided, before any context switch cost
+    int sliceQuantum;      // the slice runs up to the first multiple of this after the next arrival, 0 if unrelated to arrivals
+    long long busyTime;    // total length of the time slices ended so far
+    long long switchTime;  // time spent switching between processes
+    int migrations;        // processes stolen from the ready queues of other CPUs
+
+    // Fair share only, otherwise NULL: heap holds nothing and processes are kept per class instead
+    classQueue *classes;   // groupCount * SCHEDULER_PRIORITY_LEVELS, index group * SCHEDULER_PRIORITY_LEVELS + priority
+    int *groupTree;        // tournament tree over the groups with processes here, 1-based, the root has the lowest virtual time
+} cpuState;
+
+typedef struct burstStatistics
+{
+    // Burst times of every process admitted so far, maintained incrementally for the adaptive time quantum
+    // Histogram buckets kept in a Fenwick tree give percentiles in O(log buckets), within 1/8 of the burst time,
+    // Welford's running mean and variance give mean + k standard deviations
+    int tree[SCHEDULER_HISTOGRAM_BUCKETS + 1]; // Fenwick tree over the bucket counts, 1-based
+    int count;
+    double mean;
+    double m2; // sum of squared differences from the mean
+} burstStatistics;
+
+typedef struct schedulingPolicy
+{
+    // Policy vtable: the order processes are dispatched in and how long a dispatched process holds the CPU
+    // A new policy is a new entry of schedulingPolicies, indexed by schedulerPolicy
+    const char *name;
+    bool (*isLower)(const jobTable *jobs, int a, int b);          // heap ordering, the lowest process is dispatched next
+    int (*timeSlice)(scheduler *s, cpuState *cpu, int fid);       // length of the time slice given to process fid
+    void (*endTimeSlice)(scheduler *s, int fid, int sliceLength); // process leaves the CPU uncompleted, may be NULL
+} schedulingPolicy;
+
+typedef struct arrivalEntry
+{
+    int arrivalTime;
+    int fileID;
+    int sequence; // ties on arrival time go in order of adding, fids are reused once processes complete
+} arrivalEntry;
+
+typedef struct arrivalCursor
+{
+    // queue of processes added but not yet admitted, next points at the first one not yet added to the ready queue
+    // sorted by (arrival time, sequence) when stepping starts, later additions arrive in order
+    arrivalEntry *order;
+    int count;
+    int next;
+    int capacity;
+    int lastArrivalTime; // latest arrival time added so far
+} arrivalCursor;
+
+typedef struct completionSummary
+{
+    // Running totals of completed processes, accumulated in order of completion
+    // The totals are exact, with retainCompletions they are left at 0 and reduced from the completed table instead
+    int count;
+    long long totalWaitingTime;
+    long long totalTurnAroundTime;
+    long long totalResponseTime;
+    long long totalDispatches;
+    int maxDispatches;
+    int maxWaitingTime;
+    int minWaitingTime;
+    int maxTurnAroundTime;
+    int minTurnAroundTime;
+} completionSummary;
+
+typedef struct classSummary
+{
+    // Running totals of one priority class or group
+    int count;
+    double totalWaitingTime;
+    double totalTurnAroundTime;
+    int maxWaitingTime;
+    int maxTurnAroundTime;
+    long long serviceTime;
+} classSummary;
+
+struct scheduler
+{
+    schedulerOptions options;
+    const schedulingPolicy *policy; // options.policy
+    int timeQuantum;                // options.timeQuantum, or derived from bursts with an adaptive quantumMode
+    burstStatistics bursts;
+    long long contextSwitches;      // CPUs given to a different process than the one that last held them
+    long long preemptions;          // context switches away from a process that had not completed
+    long long events;               // arrivals admitted and time slices ended
+    int timeElapsed;
+    bool started;     // first step taken, pending arrivals have been sorted
+    bool inputClosed; // no more processes will be added
+    jobTable jobs;
+    completedTable completed;
+    cpuState *cpus;   // options.cpuCount CPUs, a process is admitted to the least loaded one
+    int *cpuLoad;     // uncompleted processes in the ready queue of each CPU, one column for getLeastLoadedCpu
+    int inFlight;     // processes admitted and not yet completed, over every CPU
+    arrivalCursor arrivals;
+    completionSummary summary;
+    schedulerHistogram histograms[SCHEDULER_METRIC_COUNT]; // waiting, turnaround and response time of completed processes
+    classSummary priorities[SCHEDULER_PRIORITY_LEVELS];
+    classSummary *groups;       // options.groupCount
+
+    // Fair share: a group's virtual time is the CPU time it received over its weight, the lowest is served next
+    double *groupVirtualTime;   // options.groupCount
+    int *groupInFlight;         // admitted and uncompleted processes of each group, over every CPU
+    double virtualTime;         // virtual time of the group dispatched last, a group that becomes active starts there
+    int groupTreeLeaves;        // power of two >= options.groupCount
+    int *groupWeights;          // copy of options.groupWeights, NULL for equal shares
+    int earliestArrival;        // processes added may not arrive earlier, the time of the snapshot restored from
+};
+
+typedef struct snapshotHeader
+{
+    // First bytes of a snapshot, the sizes tell a snapshot of another build apart
+    char magic[4];
+    int version;
+    int byteOrder;
+    int optionsSize;
+    int schedulerSize;
+} snapshotHeader;
+
+typedef struct snapshotState
+{
+    // Scalar state of the scheduler, followed in the file by its statistics, tables, pending arrivals and CPUs
+    int timeQuantum;
+    int timeElapsed;
+    int inFlight;
+    int hasGroupWeights;
+    long long contextSwitches;
+    long long preemptions;
+    long long events;
+    double virtualTime;
+    int jobCount;
+    int jobsAdded;
+    int freeCount;
+    int completedCount;
+    int pendingCount;
+    int lastArrivalTime;
+} snapshotState;
+
+typedef struct snapshotCpu
+{
+    // One CPU, followed by its ready queue from head to tail
+    long long busyTime;
+    long long switchTime;
+    int migrations;
+    int sliceLength;
+    int sliceEnd;
+    int sliceDispatched;
+    int sliceQuantum;
+    int processesAdded;
+    int readyCount;
+    int runningCount;
+    int completedCount;
+    int nodeCount;
+    int running; // position of runningNode in the ready queue, -1 if none
+    int slice;   // position of the process given the current time slice, -1 while idle
+} snapshotCpu;
+
+typedef struct snapshotNode
+{
+    int fileID;
+    int waiting; // fair share: in the waiting order of its class
+} snapshotNode;
+
+#ifdef SCHEDULER_PROFILE
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define PROFILE_THREAD_LOCAL _Thread_local
+#else
+#define PROFILE_THREAD_LOCAL __thread
+#endif
+
+typedef struct profileState
+{
+    // Counters of one thread, contexts are stepped by one thread at a time so no locking is needed
+    schedulerPhaseStats phases[SCHEDULER_PHASE_COUNT];
+    long long visits;             // nodes visited so far, a phase is charged the difference over its span
+    long long origin;             // clock at SchedulerResetProfile, event times are relative to it
+    bool recordEvents;
+    schedulerPhaseEvent *events;  // allocated on the first event, PROFILE_MAX_EVENTS entries
+    long long eventCount;
+    long long droppedEvents;
+} profileState;
+
+typedef struct profileSpan
+{
+    long long start;
+    long long visits;
+} profileSpan;
+
+static PROFILE_THREAD_LOCAL profileState profile;
+
+static long long getProfileClock(void);
+static profileSpan beginProfileSpan(void);
+static void endProfileSpan(const profileSpan *span, schedulerPhase phase);
+
+// Instrumentation points, they compile to nothing without SCHEDULER_PROFILE
+#define PROFILE_BEGIN(span) profileSpan span = beginProfileSpan()
+#define PROFILE_END(span, phase) endProfileSpan(&span, phase)
+#define PROFILE_VISIT(count) (profile.visits += (count))
+#else
+#define PROFILE_BEGIN(span)
+#define PROFILE_END(span, phase)
+#define PROFILE_VISIT(count)
+#endif
+
+static void *allocateColumn(size_t count, size_t size);
+static void *reallocateColumn(void *column, size_t oldCount, size_t newCount, size_t size);
+static bool testFlag(const flagWord *flags, int i);
+static void setFlag(flagWord *flags, int i);
+static void clearFlag(flagWord *flags, int i);
+static void initJobTable(jobTable *jobs);
+static bool growJobTable(jobTable *jobs, int capacity);
+static bool ownJobColumns(jobTable *jobs);
+static int appendJob(jobTable *jobs, int sequence, int arrivalTime, int burstTime);
+static void releaseJobRow(jobTable *jobs, int row);
+static void freeJobTable(jobTable *jobs);
+static void initCompletedTable(completedTable *completed);
+static bool growCompletedTable(completedTable *completed);
+static void freeCompletedTable(completedTable *completed);
+static bool recordCompletion(scheduler *s, int fid);
+static void reduceCompletedTable(const completedTable *completed, completionSummary *summary);
+static void printFileTable(jobTable *jobs);
+static bool pushArrival(arrivalCursor *arrivals, int arrivalTime, int fileID, int sequence);
+static int compareArrivalEntries(const void *a, const void *b);
+static int getNextArrivalTime(arrivalCursor *arrivals);
+static bool populateQueueIfArrive(scheduler *s);
+static cpuState *getLeastLoadedCpu(scheduler *s);
+static int getHistogramBucket(int value);
+static int getHistogramBucketLimit(int bucket);
+static void addBurstTime(burstStatistics *bursts, int burstTime);
+static int getBurstPercentile(const burstStatistics *bursts, float percentile);
+static int getAdaptiveTimeQuantum(scheduler *s);
+static bool stealReadyProcess(scheduler *s, cpuState *thief);
+static void reclaimFreeNodes(scheduler *s, cpuState *cpu);
+static void initReadyQueue(readyQueueList *readyQueue);
+static readyQueueNode *allocateReadyQueueNode(readyQueueList *readyQueue);
+static bool AddToReadyQueue(int fileID, readyQueueList *readyQueue, readyQueueHeap *heap);
+static void LinkToReadyQueue(readyQueueNode *node, readyQueueList *readyQueue);
+static void UnlinkFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue);
+static void RemoveFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue);
+static void DispatchFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue, jobTable *jobs, int timeElapsed);
+static int GetReadyProcessCount(const readyQueueList *readyQueue);
+static int GetRunningProcessCount(const readyQueueList *readyQueue);
+static int GetCompletedProcessCount(const readyQueueList *readyQueue);
+static int CountUncompletedProcessesInQueue(const readyQueueList *readyQueue);
+static void printReadyQueueEntries(readyQueueList *readyQueue, jobTable *jobs);
+static schedulerStatus DispatchTimeSlice(scheduler *s, cpuState *cpu);
+static bool finishTimeSlice(scheduler *s, cpuState *cpu);
+static int mergedTimeQuantum(scheduler *s, cpuState *cpu, int fid, int timeQuantum);
+static void cutSlicesAtArrival(scheduler *s);
+static int HybridRoundRobin(scheduler *s, cpuState *cpu, int fid);
+static int runToCompletion(scheduler *s, cpuState *cpu, int fid);
+static int roundRobinTimeSlice(scheduler *s, cpuState *cpu, int fid);
+static int shortestRemainingTimeSlice(scheduler *s, cpuState *cpu, int fid);
+static int multilevelFeedbackTimeSlice(scheduler *s, cpuState *cpu, int fid);
+static void multilevelFeedbackDemote(scheduler *s, int fid, int sliceLength);
+static readyQueueNode *getNextFairShareProcess(scheduler *s, cpuState *cpu);
+static readyQueueNode *getOldestStealableProcess(scheduler *s, cpuState *victim);
+static void chargeFairShare(scheduler *s, int fid, int sliceLength);
+static void activateGroup(scheduler *s, int group);
+static bool isFairShare(const scheduler *s);
+static readyQueueHeap *getReadyHeap(scheduler *s, cpuState *cpu, int fid);
+static classQueue *getClassQueue(scheduler *s, cpuState *cpu, int fid);
+static void enqueueWaiting(classQueue *queue, readyQueueNode *node);
+static void dequeueWaiting(classQueue *queue, readyQueueNode *node);
+static void updateGroupTree(scheduler *s, cpuState *cpu, int group);
+static int getLowerVirtualTimeGroup(const scheduler *s, int a, int b);
+static void addClassCompletion(classSummary *summary, const schedulerCompletion *completion);
+static void getClassStats(const classSummary *summary, schedulerClassStats *stats);
+static bool writeSnapshotBlock(FILE *fp, const void *data, size_t count, size_t size);
+static bool readSnapshotBlock(FILE *fp, void *data, size_t count, size_t size);
+static void getSnapshotColumns(const scheduler *s, int **jobColumns, int **completedColumns);
+static schedulerStatus restoreSnapshot(scheduler *s, FILE *fp, const snapshotState *state);
+static bool restoreSnapshotCpu(scheduler *s, cpuState *cpu, FILE *fp);
+static bool isLowerRemainingBurstTime(const jobTable *jobs, int a, int b);
+static bool isLowerArrivalTime(const jobTable *jobs, int a, int b);
+static bool isLowerReadySince(const jobTable *jobs, int a, int b);
+static bool isLowerQueueLevel(const jobTable *jobs, int a, int b);
+static readyQueueNode *getNextProcess(readyQueueHeap *heap);
+static bool heapNodeIsLower(readyQueueHeap *heap, readyQueueNode *a, readyQueueNode *b);
+static void heapSwap(readyQueueHeap *heap, int i, int j);
+static void heapSiftUp(readyQueueHeap *heap, int i);
+static void heapSiftDown(readyQueueHeap *heap, int i);
+static bool heapPush(readyQueueHeap *heap, readyQueueNode *node);
+static void heapRemove(readyQueueHeap *heap, readyQueueNode *node);
+static void heapUpdateKey(readyQueueHeap *heap, readyQueueNode *node);
+static void freeAllocatedMemory(readyQueueList *readyQueue);
+
+static const schedulingPolicy schedulingPolicies[SCHEDULER_POLICY_COUNT] = {
+    {"Hybrid RR + SJF", isLowerRemainingBurstTime, HybridRoundRobin, NULL},
+    {"FCFS", isLowerArrivalTime, runToCompletion, NULL},
+    {"RR", isLowerReadySince, roundRobinTimeSlice, NULL},
+    {"SJF", isLowerRemainingBurstTime, runToCompletion, NULL},
+    {"SRTF", isLowerRemainingBurstTime, shortestRemainingTimeSlice, NULL},
+    {"MLFQ", isLowerQueueLevel, multilevelFeedbackTimeSlice, multilevelFeedbackDemote},
+    {"Fair share", isLowerRemainingBurstTime, roundRobinTimeSlice, NULL},
+};
+
+void SchedulerDefaultOptions(schedulerOptions *options)
+{
+    options->timeQuantum = DEFAULT_TIME_QUANTUM;
+    options->cpuCount = 1;
+    options->policy = SCHEDULER_POLICY_HYBRID;
+    options->quantumMode = SCHEDULER_QUANTUM_FIXED;
+    options->quantumPercentile = 80.0f;
+    options->quantumStddevs = 1.0f;
+    options->switchCost = 0;
+    options->retainCompletions = false;
+    options->groupCount = 1;
+    options->groupWeights = NULL;
+    options->agingInterval = DEFAULT_AGING_INTERVAL;
+    options->onCompletion = NULL;
+    options->onTimeSlice = NULL;
+    options->callbackContext = NULL;
+}
+
+scheduler *SchedulerCreate(const schedulerOptions *options)
+{
+    // Returns NULL if the options are invalid or memory could not be allocated
+    if (options == NULL || options->timeQuantum < 1 || options->cpuCount < 1 ||
+        options->policy < 0 || options->policy >= SCHEDULER_POLICY_COUNT ||
+        options->quantumMode < 0 || options->quantumMode >= SCHEDULER_QUANTUM_MODE_COUNT ||
+        !(options->quantumPercentile > 0.0f && options->quantumPercentile <= 100.0f) ||
+        !(options->quantumStddevs >= 0.0f) || options->switchCost < 0 ||
+        options->groupCount < 1 || options->agingInterval < 0)
+    {
+        return NULL;
+    }
+    for (int g = 0; options->groupWeights != NULL && g < options->groupCount; g++)
+    {
+        if (options->groupWeights[g] < 1)
+        {
+            return NULL;
+        }
+    }
+    scheduler *s = malloc(sizeof(scheduler));
+    if (s == NULL)
+    {
+        return NULL;
+    }
+    s->cpus = allocateColumn(options->cpuCount, sizeof(cpuState));
+    if (s->cpus == NULL)
+    {
+        free(s);
+        return NULL;
+    }
+    s->options = *options;
+    s->policy = &schedulingPolicies[options->policy];
+    s->timeQuantum = options->timeQuantum;
+    memset(&s->bursts, 0, sizeof(burstStatistics));
+    s->contextSwitches = 0;
+    s->preemptions = 0;
+    s->events = 0;
+    s->timeElapsed = 0;
+    s->started = false;
+    s->inputClosed = false;
+    initJobTable(&s->jobs);
+    initCompletedTable(&s->completed);
+
+    s->inFlight = 0;
+    for (int c = 0; c < options->cpuCount; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+
+        // Ready linked list starts empty, each node refers to a jobs row and is taken from a pool of nodes
+        initReadyQueue(&cpu->readyQueue);
+
+        // Heap indexing the uncompleted nodes of the ready queue, grows with the processes in flight
+        cpu->heap.nodes = NULL;
+        cpu->heap.size = 0;
+        cpu->heap.capacity = 0;
+        cpu->heap.jobs = &s->jobs;
+        cpu->heap.policy = s->policy;
+
+        cpu->slice = NULL;
+        cpu->sliceLength = 0;
+        cpu->sliceEnd = 0;
+        cpu->sliceDispatched = 0;
+        cpu->sliceQuantum = 0;
+        cpu->busyTime = 0;
+        cpu->switchTime = 0;
+        cpu->migrations = 0;
+        cpu->classes = NULL;
+        cpu->groupTree = NULL;
+    }
+
+    s->arrivals.order = NULL;
+    s->arrivals.count = 0;
+    s->arrivals.next = 0;
+    s->arrivals.capacity = 0;
+    s->arrivals.lastArrivalTime = 0;
+
+    s->summary.count = 0;
+    s->summary.totalWaitingTime = 0;
+    s->summary.totalTurnAroundTime = 0;
+    s->summary.totalResponseTime = 0;
+    s->summary.totalDispatches = 0;
+    s->summary.maxDispatches = 0;
+    for (int metric = 0; metric < SCHEDULER_METRIC_COUNT; metric++)
+    {
+        SchedulerHistogramInit(&s->histograms[metric]);
+    }
+    s->summary.maxWaitingTime = 0;
+    s->summary.minWaitingTime = 0;
+    s->summary.maxTurnAroundTime = 0;
+    s->summary.minTurnAroundTime = 0;
+
+    // Per class totals, and the per CPU class queues and group trees of the fair share policy
+    memset(s->priorities, 0, sizeof(s->priorities));
+    s->groups = allocateColumn(options->groupCount, sizeof(classSummary));
+    s->groupVirtualTime = allocateColumn(options->groupCount, sizeof(double));
+    s->groupInFlight = allocateColumn(options->groupCount, sizeof(int));
+    s->cpuLoad = allocateColumn(options->cpuCount, sizeof(int));
+    s->virtualTime = 0.0;
+    s->earliestArrival = 0;
+    s->groupWeights = NULL;
+    s->groupTreeLeaves = 1;
+    while (s->groupTreeLeaves < options->groupCount)
+    {
+        s->groupTreeLeaves *= 2;
+    }
+    if (s->groups == NULL || s->groupVirtualTime == NULL || s->groupInFlight == NULL || s->cpuLoad == NULL)
+    {
+        SchedulerDestroy(s);
+        return NULL;
+    }
+    if (options->groupWeights != NULL)
+    {
+        s->groupWeights = allocateColumn(options->groupCount, sizeof(int));
+        if (s->groupWeights == NULL)
+        {
+            SchedulerDestroy(s);
+            return NULL;
+        }
+        memcpy(s->groupWeights, options->groupWeights, (size_t)options->groupCount * sizeof(int));
+        s->options.groupWeights = s->groupWeights;
+    }
+    for (int c = 0; c < options->cpuCount && isFairShare(s); c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        cpu->classes = allocateColumn((size_t)options->groupCount * SCHEDULER_PRIORITY_LEVELS, sizeof(classQueue));
+        cpu->groupTree = allocateColumn(2 * (size_t)s->groupTreeLeaves, sizeof(int));
+        if (cpu->classes == NULL || cpu->groupTree == NULL)
+        {
+            SchedulerDestroy(s);
+            return NULL;
+        }
+        for (int i = 0; i < options->groupCount * SCHEDULER_PRIORITY_LEVELS; i++)
+        {
+            cpu->classes[i].heap.jobs = &s->jobs;
+            cpu->classes[i].heap.policy = s->policy;
+        }
+        for (int i = 0; i < 2 * s->groupTreeLeaves; i++)
+        {
+            cpu->groupTree[i] = -1; // no group has processes
+        }
+    }
+    return s;
+}
+
+void SchedulerDestroy(scheduler *s)
+{
+    if (s == NULL)
+    {
+        return;
+    }
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        freeAllocatedMemory(&cpu->readyQueue);
+        free(cpu->heap.nodes);
+        for (int i = 0; cpu->classes != NULL && i < s->options.groupCount * SCHEDULER_PRIORITY_LEVELS; i++)
+        {
+            free(cpu->classes[i].heap.nodes);
+        }
+        free(cpu->classes);
+        free(cpu->groupTree);
+    }
+    free(s->cpus);
+    free(s->groups);
+    free(s->groupVirtualTime);
+    free(s->groupInFlight);
+    free(s->cpuLoad);
+    free(s->groupWeights);
+    free(s->arrivals.order);
+    freeJobTable(&s->jobs);
+    freeCompletedTable(&s->completed);
+    free(s);
+}
+
+schedulerStatus SchedulerAddJob(scheduler *s, int arrivalTime, int burstTime)
+{
+    // Adds a process, before stepping starts in any order, afterwards no earlier than the processes already added
+    return SchedulerAddClassifiedJob(s, arrivalTime, burstTime, 0, 0);
+}
+
+schedulerStatus SchedulerAddClassifiedJob(scheduler *s, int arrivalTime, int burstTime, int priority, int group)
+{
+    // SchedulerAddJob for a process of a priority class (0 is the highest) and a group below options.groupCount
+    return SchedulerAddNumberedJob(s, s->jobs.added, arrivalTime, burstTime, priority, group);
+}
+
+schedulerStatus SchedulerAddNumberedJob(scheduler *s, int process, int arrivalTime, int burstTime, int priority, int group)
+{
+    // SchedulerAddClassifiedJob numbered process instead of in order of adding, e.g., its row in a trace that is
+    // streamed in arrival order, so ties are broken as if the trace had been added whole. Numbers must be unique
+    if (process < 0 || arrivalTime < 0 || burstTime < 0 || priority < 0 || priority >= SCHEDULER_PRIORITY_LEVELS ||
+        group < 0 || group >= s->options.groupCount)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    if (s->inputClosed)
+    {
+        return SCHEDULER_INPUT_CLOSED;
+    }
+    if ((s->started && arrivalTime < s->arrivals.lastArrivalTime) || arrivalTime < s->earliestArrival)
+    {
+        return SCHEDULER_ARRIVAL_OUT_OF_ORDER;
+    }
+    int row = appendJob(&s->jobs, process, arrivalTime, burstTime);
+    if (row == -1)
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    s->jobs.priority[row] = priority;
+    s->jobs.group[row] = group;
+    if (!pushArrival(&s->arrivals, arrivalTime, row, s->jobs.sequence[row]))
+    {
+        releaseJobRow(&s->jobs, row);
+        s->jobs.added--;
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerAddJobColumns(scheduler *s, const int *arrivalTime, const int *burstTime, int count)
+{
+    // Adds count processes at once from arrival and burst time columns
+    // Into an empty scheduler the columns are used in place, they must then outlive the scheduler and stay unchanged
+    if (count < 0)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (arrivalTime[i] < 0 || burstTime[i] < 0)
+        {
+            return SCHEDULER_INVALID_ARGUMENT;
+        }
+    }
+    if (s->jobs.added > 0 || s->started || s->inputClosed)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            schedulerStatus status = SchedulerAddJob(s, arrivalTime[i], burstTime[i]);
+            if (status != SCHEDULER_OK)
+            {
+                return status;
+            }
+        }
+        return SCHEDULER_OK;
+    }
+
+    jobTable *jobs = &s->jobs;
+    free(jobs->arrivalTime);
+    free(jobs->burstTime);
+    jobs->arrivalTime = (int *)arrivalTime;
+    jobs->burstTime = (int *)burstTime;
+    jobs->borrowedColumns = true;
+    jobs->capacity = 0;
+    if (!growJobTable(jobs, count > 0 ? count : 1))
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    memcpy(jobs->backUpBurstTime, burstTime, (size_t)count * sizeof(int));
+    for (int i = 0; i < count; i++)
+    {
+        jobs->sequence[i] = i;
+        if (!pushArrival(&s->arrivals, arrivalTime[i], i, i))
+        {
+            return SCHEDULER_OUT_OF_MEMORY;
+        }
+        if (s->arrivals.lastArrivalTime < arrivalTime[i])
+        {
+            s->arrivals.lastArrivalTime = arrivalTime[i];
+        }
+    }
+    jobs->count = count;
+    jobs->added = count;
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerAddJobClassColumns(scheduler *s, const int *arrivalTime, const int *burstTime,
+                                            const int *priority, const int *group, int count)
+{
+    // SchedulerAddJobColumns with a priority class and a group per process, either column may be NULL for all 0
+    // The class columns are copied, only arrival and burst time are used in place
+    for (int i = 0; i < count; i++)
+    {
+        if ((priority != NULL && (priority[i] < 0 || priority[i] >= SCHEDULER_PRIORITY_LEVELS)) ||
+            (group != NULL && (group[i] < 0 || group[i] >= s->options.groupCount)))
+        {
+            return SCHEDULER_INVALID_ARGUMENT;
+        }
+    }
+    if (s->jobs.added > 0 || s->started || s->inputClosed)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            schedulerStatus status = SchedulerAddClassifiedJob(s, arrivalTime[i], burstTime[i],
+                                                               priority != NULL ? priority[i] : 0, group != NULL ? group[i] : 0);
+            if (status != SCHEDULER_OK)
+            {
+                return status;
+            }
+        }
+        return SCHEDULER_OK;
+    }
+    schedulerStatus status = SchedulerAddJobColumns(s, arrivalTime, burstTime, count);
+    if (status == SCHEDULER_OK && count > 0)
+    {
+        // rows of an empty scheduler are the processes in order
+        if (priority != NULL)
+        {
+            memcpy(s->jobs.priority, priority, (size_t)count * sizeof(int));
+        }
+        if (group != NULL)
+        {
+            memcpy(s->jobs.group, group, (size_t)count * sizeof(int));
+        }
+    }
+    return status;
+}
+
+schedulerStatus SchedulerSetBurstTime(scheduler *s, int process, int burstTime)
+{
+    // Changes the burst time of a process that has not arrived yet, e.g., for a what-if run from a snapshot
+    // process is numbered in order of adding from 0, as in schedulerCompletion.process
+    if (burstTime < 0)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    arrivalCursor *arrivals = &s->arrivals;
+    for (int i = arrivals->next; i < arrivals->count; i++)
+    {
+        if (arrivals->order[i].sequence == process)
+        {
+            int row = arrivals->order[i].fileID;
+            if (s->jobs.borrowedColumns && !ownJobColumns(&s->jobs))
+            {
+                return SCHEDULER_OUT_OF_MEMORY;
+            }
+            s->jobs.burstTime[row] = burstTime;
+            s->jobs.backUpBurstTime[row] = burstTime;
+            return SCHEDULER_OK;
+        }
+    }
+    return SCHEDULER_INVALID_ARGUMENT;
+}
+
+void SchedulerCloseInput(scheduler *s)
+{
+    s->inputClosed = true;
+}
+
+bool SchedulerNeedsArrival(scheduler *s)
+{
+    // While input is open the next decision depends on the next arrival, which must be added first
+    // Pending arrivals are in order once stepping started, so one later than now is known if the latest is
+    if (s->inputClosed)
+    {
+        return false;
+    }
+    return s->arrivals.next == s->arrivals.count || s->arrivals.lastArrivalTime <= s->timeElapsed;
+}
+
+schedulerStatus SchedulerStep(scheduler *s)
+{
+    // Handles one scheduling event: time slices ending now are accounted for, processes whose arrival time is
+    // lower or equals to the time elapsed are added into a ready queue, then every idle CPU is given a time slice.
+    // Time then jumps to the next time slice to end, or to the next arrival while a CPU is idle
+    // Returns SCHEDULER_FINISHED once input is closed and every process completed, while input is open and
+    // nothing is left to schedule it returns SCHEDULER_OK without advancing time
+    if (!s->started)
+    {
+        // Index processes by arrival time once, so each event only looks at processes that newly arrived
+        // Traces are usually already in arrival order, the sort is skipped then
+        arrivalCursor *arrivals = &s->arrivals;
+        int i = arrivals->next + 1;
+        while (i < arrivals->count && compareArrivalEntries(&arrivals->order[i - 1], &arrivals->order[i]) <= 0)
+        {
+            i++;
+        }
+        if (i < arrivals->count)
+        {
+            qsort(arrivals->order + arrivals->next, arrivals->count - arrivals->next, sizeof(arrivalEntry), compareArrivalEntries);
+        }
+        cutSlicesAtArrival(s);
+        s->started = true;
+    }
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        if (cpu->slice != NULL && cpu->sliceEnd <= s->timeElapsed)
+        {
+            PROFILE_BEGIN(finish);
+            bool finished = finishTimeSlice(s, cpu);
+            PROFILE_END(finish, SCHEDULER_PHASE_FINISH);
+            if (!finished)
+            {
+                return SCHEDULER_OUT_OF_MEMORY;
+            }
+        }
+    }
+    PROFILE_BEGIN(admit);
+    bool admitted = populateQueueIfArrive(s);
+    PROFILE_END(admit, SCHEDULER_PHASE_ADMIT);
+    if (!admitted)
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    int nextArrival = getNextArrivalTime(&s->arrivals);
+    if (s->inFlight == 0 && nextArrival == -1)
+    {
+        return s->inputClosed ? SCHEDULER_FINISHED : SCHEDULER_OK;
+    }
+
+    // CPUs are served in index order, an idle CPU with an empty ready queue steals from the others
+    int nextEvent = -1;
+    bool idle = false;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        if (cpu->slice == NULL)
+        {
+            PROFILE_BEGIN(dispatch);
+            schedulerStatus status = DispatchTimeSlice(s, cpu);
+            PROFILE_END(dispatch, SCHEDULER_PHASE_DISPATCH);
+            if (status != SCHEDULER_OK)
+            {
+                return status;
+            }
+        }
+        if (cpu->slice == NULL)
+        {
+            idle = true;
+        }
+        else if (nextEvent == -1 || cpu->sliceEnd < nextEvent)
+        {
+            nextEvent = cpu->sliceEnd;
+        }
+    }
+    // Arrivals while every CPU is busy are admitted when the next time slice ends, still deemed added at their arrival time
+    if (nextArrival != -1 && idle && (nextEvent == -1 || nextArrival < nextEvent))
+    {
+        nextEvent = nextArrival;
+    }
+    s->timeElapsed = nextEvent;
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerRun(scheduler *s)
+{
+    // Closes input and steps until every process has completed
+    SchedulerCloseInput(s);
+    schedulerStatus status;
+    while ((status = SchedulerStep(s)) == SCHEDULER_OK)
+    {
+    }
+    return status == SCHEDULER_FINISHED ? SCHEDULER_OK : status;
+}
+
+// Scheduler state, O(CPUs) so queue depth can be polled e.g., for monitoring
+int SchedulerGetTime(const scheduler *s)
+{
+    return s->timeElapsed;
+}
+
+int SchedulerGetReadyCount(const scheduler *s)
+{
+    int count = 0;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        count += GetReadyProcessCount(&s->cpus[c].readyQueue);
+    }
+    return count;
+}
+
+int SchedulerGetRunningCount(const scheduler *s)
+{
+    int count = 0;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        count += GetRunningProcessCount(&s->cpus[c].readyQueue);
+    }
+    return count;
+}
+
+int SchedulerGetCompletedCount(const scheduler *s)
+{
+    int count = 0;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        count += GetCompletedProcessCount(&s->cpus[c].readyQueue);
+    }
+    return count;
+}
+
+int SchedulerGetCpuCount(const scheduler *s)
+{
+    return s->options.cpuCount;
+}
+
+schedulerStatus SchedulerGetCpuStats(const scheduler *s, int cpu, schedulerCpuStats *stats)
+{
+    // Activity of one CPU, utilization is its busy time over the time elapsed
+    if (cpu < 0 || cpu >= s->options.cpuCount)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    const cpuState *state = &s->cpus[cpu];
+    stats->busyTime = state->busyTime;
+    stats->switchTime = state->switchTime;
+    stats->utilization = s->timeElapsed > 0 ? (float)state->busyTime / s->timeElapsed : 0.0f;
+    stats->migrations = state->migrations;
+    stats->completed = GetCompletedProcessCount(&state->readyQueue);
+    return SCHEDULER_OK;
+}
+
+void SchedulerGetResults(const scheduler *s, schedulerResults *results)
+{
+    // Average, max and min turnaround and waiting times of the processes completed so far
+    // With retainCompletions they are reduced from the columns of the completed table, O(completed)
+    completionSummary reduced = s->summary;
+    const completionSummary *summary = &reduced;
+    if (s->options.retainCompletions)
+    {
+        reduceCompletedTable(&s->completed, &reduced);
+    }
+    results->completed = summary->count;
+    results->averageTurnaroundTime = (float)((double)summary->totalTurnAroundTime / summary->count);
+    results->maxTurnaroundTime = summary->maxTurnAroundTime;
+    results->averageWaitingTime = (float)((double)summary->totalWaitingTime / summary->count);
+    results->maxWaitingTime = summary->maxWaitingTime;
+    results->minWaitingTime = summary->minWaitingTime;
+    results->minTurnaroundTime = summary->minTurnAroundTime;
+    results->averageResponseTime = (float)((double)summary->totalResponseTime / summary->count);
+    results->timeQuantum = s->timeQuantum;
+    results->contextSwitches = s->contextSwitches;
+    results->preemptions = s->preemptions;
+    results->events = s->events;
+    results->switchTime = 0;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        results->switchTime += s->cpus[c].switchTime;
+    }
+    results->averageDispatches = (float)((double)summary->totalDispatches / summary->count);
+    results->maxDispatches = summary->maxDispatches;
+}
+
+schedulerStatus SchedulerGetCompletion(const scheduler *s, int i, schedulerCompletion *completion)
+{
+    // i-th process to complete, only available with schedulerOptions.retainCompletions
+    const completedTable *completed = &s->completed;
+    if (!s->options.retainCompletions || i < 0 || i >= completed->count)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    completion->process = completed->fileID[i];
+    completion->completionTime = completed->completionTime[i];
+    completion->waitingTime = completed->waitingTime[i];
+    completion->turnAroundTime = completed->turnAroundTime[i];
+    completion->responseTime = completed->responseTime[i];
+    completion->dispatches = completed->dispatches[i];
+    completion->priority = completed->priority[i];
+    completion->group = completed->group[i];
+    completion->burstTime = completed->turnAroundTime[i] - completed->waitingTime[i];
+    completion->arrivalTime = completed->completionTime[i] - completed->turnAroundTime[i];
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerGetPriorityStats(const scheduler *s, int priority, schedulerClassStats *stats)
+{
+    // Processes of one priority class completed so far
+    if (priority < 0 || priority >= SCHEDULER_PRIORITY_LEVELS)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    getClassStats(&s->priorities[priority], stats);
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerGetGroupStats(const scheduler *s, int group, schedulerClassStats *stats)
+{
+    // Processes of one group completed so far
+    if (group < 0 || group >= s->options.groupCount)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    getClassStats(&s->groups[group], stats);
+    return SCHEDULER_OK;
+}
+
+schedulerStatus SchedulerGetHistogram(const scheduler *s, schedulerMetric metric, schedulerHistogram *histogram)
+{
+    // Copy of the histogram of one metric over the processes completed so far
+    if (metric < 0 || metric >= SCHEDULER_METRIC_COUNT)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    *histogram = s->histograms[metric];
+    return SCHEDULER_OK;
+}
+
+void SchedulerHistogramInit(schedulerHistogram *histogram)
+{
+    memset(histogram, 0, sizeof(schedulerHistogram));
+}
+
+void SchedulerHistogramAdd(schedulerHistogram *histogram, int value)
+{
+    // O(1) apart from finding the power of two, negative times are counted as 0
+    if (value < 0)
+    {
+        value = 0;
+    }
+    histogram->counts[getHistogramBucket(value)]++;
+    if (histogram->count == 0 || histogram->min > value)
+    {
+        histogram->min = value;
+    }
+    if (histogram->count == 0 || histogram->max < value)
+    {
+        histogram->max = value;
+    }
+    histogram->count++;
+}
+
+void SchedulerHistogramMerge(schedulerHistogram *into, const schedulerHistogram *from)
+{
+    // Adds the counts of from, e.g., to report over several runs or CPUs at once
+    if (from->count == 0)
+    {
+        return;
+    }
+    for (int bucket = 0; bucket < SCHEDULER_HISTOGRAM_BUCKETS; bucket++)
+    {
+        into->counts[bucket] += from->counts[bucket];
+    }
+    if (into->count == 0 || into->min > from->min)
+    {
+        into->min = from->min;
+    }
+    if (into->count == 0 || into->max < from->max)
+    {
+        into->max = from->max;
+    }
+    into->count += from->count;
+}
+
+int SchedulerHistogramPercentile(const schedulerHistogram *histogram, double percentile)
+{
+    // Smallest time at or below which percentile % of the values fall, rounded up to the limit of its bucket
+    // (at most 1/8 above the exact value) and clamped to the observed min and max, 0 if empty
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+    long long rank = (long long)ceil(percentile / 100.0 * histogram->count);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    long long seen = 0;
+    int bucket = 0;
+    while (bucket < SCHEDULER_HISTOGRAM_BUCKETS - 1 && seen + histogram->counts[bucket] < rank)
+    {
+        seen += histogram->counts[bucket];
+        bucket++;
+    }
+    int value = getHistogramBucketLimit(bucket);
+    if (value > histogram->max)
+    {
+        value = histogram->max;
+    }
+    return value < histogram->min ? histogram->min : value;
+}
+
+schedulerStatus SchedulerSaveSnapshot(const scheduler *s, FILE *fp)
+{
+    // Writes the state between two steps: clock, statistics, job and completed tables, pending arrivals
+    // and every CPU with its ready queue and time slice. Heaps and fair share trees are rebuilt on load
+    snapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.optionsSize = sizeof(schedulerOptions);
+    header.schedulerSize = sizeof(scheduler);
+
+    // Callbacks and pointers do not outlive this process, the caller of SchedulerLoadSnapshot supplies them
+    schedulerOptions options;
+    memset(&options, 0, sizeof(options));
+    options.timeQuantum = s->options.timeQuantum;
+    options.cpuCount = s->options.cpuCount;
+    options.policy = s->options.policy;
+    options.quantumMode = s->options.quantumMode;
+    options.quantumPercentile = s->options.quantumPercentile;
+    options.quantumStddevs = s->options.quantumStddevs;
+    options.switchCost = s->options.switchCost;
+    options.retainCompletions = s->options.retainCompletions;
+    options.groupCount = s->options.groupCount;
+    options.agingInterval = s->options.agingInterval;
+
+    snapshotState scalars;
+    memset(&scalars, 0, sizeof(scalars));
+    scalars.timeQuantum = s->timeQuantum;
+    scalars.timeElapsed = s->timeElapsed;
+    scalars.inFlight = s->inFlight;
+    scalars.hasGroupWeights = s->groupWeights != NULL;
+    scalars.contextSwitches = s->contextSwitches;
+    scalars.preemptions = s->preemptions;
+    scalars.events = s->events;
+    scalars.virtualTime = s->virtualTime;
+    scalars.jobCount = s->jobs.count;
+    scalars.jobsAdded = s->jobs.added;
+    scalars.freeCount = s->jobs.freeCount;
+    scalars.completedCount = s->options.retainCompletions ? s->completed.count : 0;
+    scalars.pendingCount = s->arrivals.count - s->arrivals.next;
+    scalars.lastArrivalTime = s->arrivals.lastArrivalTime;
+
+    int groupCount = s->options.groupCount;
+    int words = (s->jobs.count + FLAG_WORD_BITS - 1) / FLAG_WORD_BITS;
+    bool written = writeSnapshotBlock(fp, &header, 1, sizeof(header)) &&
+                   writeSnapshotBlock(fp, &options, 1, sizeof(options)) &&
+                   writeSnapshotBlock(fp, &scalars, 1, sizeof(scalars)) &&
+                   writeSnapshotBlock(fp, s->groupWeights, scalars.hasGroupWeights ? groupCount : 0, sizeof(int)) &&
+                   writeSnapshotBlock(fp, &s->bursts, 1, sizeof(burstStatistics)) &&
+                   writeSnapshotBlock(fp, &s->summary, 1, sizeof(completionSummary)) &&
+                   writeSnapshotBlock(fp, s->histograms, SCHEDULER_METRIC_COUNT, sizeof(schedulerHistogram)) &&
+                   writeSnapshotBlock(fp, s->priorities, SCHEDULER_PRIORITY_LEVELS, sizeof(classSummary)) &&
+                   writeSnapshotBlock(fp, s->groups, groupCount, sizeof(classSummary)) &&
+                   writeSnapshotBlock(fp, s->groupVirtualTime, groupCount, sizeof(double)) &&
+                   writeSnapshotBlock(fp, s->groupInFlight, groupCount, sizeof(int));
+
+    int *jobColumns[SNAPSHOT_JOB_COLUMNS];
+    int *completedColumns[SNAPSHOT_COMPLETED_COLUMNS];
+    getSnapshotColumns(s, jobColumns, completedColumns);
+    for (int c = 0; c < SNAPSHOT_JOB_COLUMNS && written; c++)
+    {
+        written = writeSnapshotBlock(fp, jobColumns[c], scalars.jobCount, sizeof(int));
+    }
+    for (int c = 0; c < SNAPSHOT_COMPLETED_COLUMNS && written; c++)
+    {
+        written = writeSnapshotBlock(fp, completedColumns[c], scalars.completedCount, sizeof(int));
+    }
+    written = written &&
+              writeSnapshotBlock(fp, s->jobs.hasArrived, words, sizeof(flagWord)) &&
+              writeSnapshotBlock(fp, s->jobs.hasCompleted, words, sizeof(flagWord)) &&
+              writeSnapshotBlock(fp, s->jobs.inQueue, words, sizeof(flagWord)) &&
+              writeSnapshotBlock(fp, s->jobs.freeRows, scalars.freeCount, sizeof(int)) &&
+              writeSnapshotBlock(fp, s->arrivals.order + s->arrivals.next, scalars.pendingCount, sizeof(arrivalEntry));
+
+    for (int c = 0; c < s->options.cpuCount && written; c++)
+    {
+        const cpuState *cpu = &s->cpus[c];
+        snapshotCpu saved;
+        memset(&saved, 0, sizeof(saved));
+        saved.busyTime = cpu->busyTime;
+        saved.switchTime = cpu->switchTime;
+        saved.migrations = cpu->migrations;
+        saved.sliceLength = cpu->sliceLength;
+        saved.sliceEnd = cpu->sliceEnd;
+        saved.sliceDispatched = cpu->sliceDispatched;
+        saved.sliceQuantum = cpu->sliceQuantum;
+        saved.processesAdded = cpu->readyQueue.processesAdded;
+        saved.readyCount = cpu->readyQueue.readyCount;
+        saved.runningCount = cpu->readyQueue.runningCount;
+        saved.completedCount = cpu->readyQueue.completedCount;
+        saved.running = -1;
+        saved.slice = -1;
+        for (readyQueueNode *node = cpu->readyQueue.head; node != NULL; node = node->next)
+        {
+            if (node == cpu->readyQueue.runningNode)
+            {
+                saved.running = saved.nodeCount;
+            }
+            if (node == cpu->slice)
+            {
+                saved.slice = saved.nodeCount;
+            }
+            saved.nodeCount++;
+        }
+        written = writeSnapshotBlock(fp, &saved, 1, sizeof(saved));
+        for (readyQueueNode *node = cpu->readyQueue.head; node != NULL && written; node = node->next)
+        {
+            snapshotNode entry;
+            entry.fileID = node->fileID;
+            entry.waiting = node->waiting;
+            written = writeSnapshotBlock(fp, &entry, 1, sizeof(entry));
+        }
+    }
+    return written ? SCHEDULER_OK : SCHEDULER_IO_ERROR;
+}
+
+schedulerStatus SchedulerLoadSnapshot(FILE *fp, const schedulerOptions *callbacks, scheduler **restored)
+{
+    // Continues a saved simulation in a new context, every option is the snapshot's apart from the callbacks
+    // and callbackContext of callbacks (NULL for none). Input is open again: processes may be added that arrive
+    // no earlier than the snapshot, in any order, until the next step
+    *restored = NULL;
+    snapshotHeader header;
+    schedulerOptions options;
+    snapshotState state;
+    if (!readSnapshotBlock(fp, &header, 1, sizeof(header)) || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.byteOrder != SNAPSHOT_BYTE_ORDER ||
+        header.optionsSize != (int)sizeof(schedulerOptions) || header.schedulerSize != (int)sizeof(scheduler) ||
+        !readSnapshotBlock(fp, &options, 1, sizeof(options)) || !readSnapshotBlock(fp, &state, 1, sizeof(state)) ||
+        options.groupCount < 1 || options.groupCount > INT_MAX / SCHEDULER_PRIORITY_LEVELS)
+    {
+        return SCHEDULER_IO_ERROR;
+    }
+    int *groupWeights = NULL;
+    if (state.hasGroupWeights)
+    {
+        groupWeights = allocateColumn(options.groupCount, sizeof(int));
+        if (groupWeights == NULL)
+        {
+            return SCHEDULER_OUT_OF_MEMORY;
+        }
+        if (!readSnapshotBlock(fp, groupWeights, options.groupCount, sizeof(int)))
+        {
+            free(groupWeights);
+            return SCHEDULER_IO_ERROR;
+        }
+    }
+    options.groupWeights = groupWeights;
+    options.onCompletion = callbacks != NULL ? callbacks->onCompletion : NULL;
+    options.onTimeSlice = callbacks != NULL ? callbacks->onTimeSlice : NULL;
+    options.callbackContext = callbacks != NULL ? callbacks->callbackContext : NULL;
+    scheduler *s = SchedulerCreate(&options); // copies groupWeights
+    free(groupWeights);
+    if (s == NULL)
+    {
+        return SCHEDULER_IO_ERROR; // options of a valid snapshot were accepted once, out of memory is unlikely here
+    }
+    schedulerStatus status = restoreSnapshot(s, fp, &state);
+    if (status != SCHEDULER_OK)
+    {
+        SchedulerDestroy(s);
+        return status;
+    }
+    *restored = s;
+    return SCHEDULER_OK;
+}
+
+void SchedulerDump(scheduler *s)
+{
+    // Prints the job table and the ready queue, mainly for debugging and report
+    printf("Time elapsed: %i\n", s->timeElapsed);
+    printFileTable(&s->jobs);
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        printf("CPU %i\n", c);
+        printReadyQueueEntries(&s->cpus[c].readyQueue, &s->jobs);
+    }
+}
+
+const char *SchedulerPolicyName(schedulerPolicy policy)
+{
+    if (policy < 0 || policy >= SCHEDULER_POLICY_COUNT)
+    {
+        return "Unknown policy";
+    }
+    return schedulingPolicies[policy].name;
+}
+
+const char *SchedulerPhaseName(schedulerPhase phase)
+{
+    static const char *const names[SCHEDULER_PHASE_COUNT] = {"Admit", "Enqueue", "Select", "Settle", "Dispatch", "Finish"};
+    if (phase < 0 || phase >= SCHEDULER_PHASE_COUNT)
+    {
+        return "Unknown phase";
+    }
+    return names[phase];
+}
+
+const char *SchedulerStatusString(schedulerStatus status)
+{
+    switch (status)
+    {
+    case SCHEDULER_OK:
+        return "OK";
+    case SCHEDULER_FINISHED:
+        return "Every process has completed";
+    case SCHEDULER_OUT_OF_MEMORY:
+        return "Failed to allocate memory";
+    case SCHEDULER_INVALID_ARGUMENT:
+        return "Invalid argument";
+    case SCHEDULER_ARRIVAL_OUT_OF_ORDER:
+        return "Arrival time out of order";
+    case SCHEDULER_INPUT_CLOSED:
+        return "Input already closed";
+    case SCHEDULER_IO_ERROR:
+        return "Snapshot could not be written or read";
+    }
+    return "Unknown status";
+}
+
+void SchedulerResetProfile(bool recordEvents)
+{
+    // Clears the counters of the calling thread and restarts its clock
+    // recordEvents keeps each phase call for SchedulerGetPhaseEvent, otherwise the event buffer is released
+#ifdef SCHEDULER_PROFILE
+    schedulerPhaseEvent *events = profile.events;
+    if (!recordEvents)
+    {
+        free(events);
+        events = NULL;
+    }
+    memset(&profile, 0, sizeof(profile));
+    profile.events = events;
+    profile.recordEvents = recordEvents;
+    profile.origin = getProfileClock();
+#endif
+}
+
+void SchedulerGetProfile(schedulerProfile *profileOut)
+{
+    memset(profileOut, 0, sizeof(*profileOut));
+#ifdef SCHEDULER_PROFILE
+    profileOut->enabled = true;
+    memcpy(profileOut->phases, profile.phases, sizeof(profile.phases));
+    profileOut->events = profile.eventCount;
+    profileOut->droppedEvents = profile.droppedEvents;
+#endif
+}
+
+schedulerStatus SchedulerGetPhaseEvent(long long i, schedulerPhaseEvent *event)
+{
+    // i-th phase call of the calling thread since SchedulerResetProfile(true), in order of ending
+#ifdef SCHEDULER_PROFILE
+    if (i >= 0 && i < profile.eventCount)
+    {
+        *event = profile.events[i];
+        return SCHEDULER_OK;
+    }
+#endif
+    return SCHEDULER_INVALID_ARGUMENT;
+}
+
+static void *allocateColumn(size_t count, size_t size)
+{
+    // Allocates a zeroed column on the heap, at least 1 entry so an empty input still gets a valid pointer
+    // NULL if out of memory
+    return calloc(count > 0 ? count : 1, size);
+}
+
+static void *reallocateColumn(void *column, size_t oldCount, size_t newCount, size_t size)
+{
+    // Resizes a column to newCount entries, entries past oldCount start zeroed like allocateColumn
+    // NULL if out of memory, column is then left as it was
+    void *resized = realloc(column, (newCount > 0 ? newCount : 1) * size);
+    if (resized == NULL)
+    {
+        return NULL;
+    }
+    if (newCount > oldCount)
+    {
+        memset((char *)resized + oldCount * size, 0, (newCount - oldCount) * size);
+    }
+    return resized;
+}
+
+static bool testFlag(const flagWord *flags, int i)
+{
+    return (flags[i / FLAG_WORD_BITS] >> (i % FLAG_WORD_BITS)) & 1ULL;
+}
+
+static void setFlag(flagWord *flags, int i)
+{
+    flags[i / FLAG_WORD_BITS] |= 1ULL << (i % FLAG_WORD_BITS);
+}
+
+static void clearFlag(flagWord *flags, int i)
+{
+    flags[i / FLAG_WORD_BITS] &= ~(1ULL << (i % FLAG_WORD_BITS));
+}
+
+static void initJobTable(jobTable *jobs)
+{
+    // Initializing file table contents, fileID == row of the process in every column
+    // Columns are allocated when the first process is added
+    jobs->count = 0;
+    jobs->capacity = 0;
+    jobs->added = 0;
+    jobs->sequence = NULL;
+    jobs->arrivalTime = NULL;
+    jobs->burstTime = NULL;
+    jobs->backUpBurstTime = NULL;
+    jobs->waitingTime = NULL;
+    jobs->responseTime = NULL;
+    jobs->readySince = NULL;
+    jobs->queueLevel = NULL;
+    jobs->dispatchCount = NULL;
+    jobs->priority = NULL;
+    jobs->group = NULL;
+    jobs->hasArrived = NULL;
+    jobs->hasCompleted = NULL;
+    jobs->inQueue = NULL;
+    jobs->borrowedColumns = false;
+    jobs->freeRows = NULL;
+    jobs->freeCount = 0;
+}
+
+// Resizes a column through reallocateColumn, returning false from the enclosing function if out of memory
+#define GROW_JOB_COLUMN(column, oldCount, newCount, size)                        \
+    do                                                                           \
+    {                                                                            \
+        void *resized = reallocateColumn((column), (oldCount), (newCount), size); \
+        if (resized == NULL)                                                     \
+        {                                                                        \
+            return false;                                                        \
+        }                                                                        \
+        (column) = resized;                                                      \
+    } while (0)
+
+static bool growJobTable(jobTable *jobs, int capacity)
+{
+    // Resizes every column to capacity rows, new rows start without arrival, burst or response time
+    // Borrowed arrival and burst columns already hold every row, they are left as is
+    int oldCapacity = jobs->capacity;
+    int oldWords = (oldCapacity + FLAG_WORD_BITS - 1) / FLAG_WORD_BITS;
+    int words = (capacity + FLAG_WORD_BITS - 1) / FLAG_WORD_BITS;
+    if (!jobs->borrowedColumns)
+    {
+        GROW_JOB_COLUMN(jobs->arrivalTime, oldCapacity, capacity, sizeof(int));
+        GROW_JOB_COLUMN(jobs->burstTime, oldCapacity, capacity, sizeof(int));
+        for (int i = oldCapacity; i < capacity; i++)
+        {
+            jobs->arrivalTime[i] = -1;
+            jobs->burstTime[i] = -1;
+        }
+    }
+    GROW_JOB_COLUMN(jobs->sequence, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->backUpBurstTime, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->waitingTime, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->responseTime, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->readySince, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->queueLevel, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->dispatchCount, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->priority, oldCapacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(jobs->group, oldCapacity, capacity, sizeof(int));
+    for (int i = oldCapacity; i < capacity; i++)
+    {
+        jobs->backUpBurstTime[i] = -1;
+        jobs->responseTime[i] = -1;
+    }
+
+    GROW_JOB_COLUMN(jobs->hasArrived, oldWords, words, sizeof(flagWord));
+    GROW_JOB_COLUMN(jobs->hasCompleted, oldWords, words, sizeof(flagWord));
+    GROW_JOB_COLUMN(jobs->inQueue, oldWords, words, sizeof(flagWord));
+    GROW_JOB_COLUMN(jobs->freeRows, oldCapacity, capacity, sizeof(int));
+    jobs->capacity = capacity;
+    return true;
+}
+
+static bool ownJobColumns(jobTable *jobs)
+{
+    // Copies borrowed arrival and burst columns before the table writes to them
+    int *arrivalTime = allocateColumn(jobs->capacity, sizeof(int));
+    int *burstTime = allocateColumn(jobs->capacity, sizeof(int));
+    if (arrivalTime == NULL || burstTime == NULL)
+    {
+        free(arrivalTime);
+        free(burstTime);
+        return false;
+    }
+    memcpy(arrivalTime, jobs->arrivalTime, (size_t)jobs->count * sizeof(int));
+    memcpy(burstTime, jobs->burstTime, (size_t)jobs->count * sizeof(int));
+    jobs->arrivalTime = arrivalTime;
+    jobs->burstTime = burstTime;
+    jobs->borrowedColumns = false;
+    return true;
+}
+
+static int appendJob(jobTable *jobs, int sequence, int arrivalTime, int burstTime)
+{
+    // Adds a row for a new process numbered sequence and returns it (-1 if out of memory), doubling the columns when they are full
+    // A row released by a completed process is reused first, so the table only grows with the processes in flight
+    if (jobs->borrowedColumns && !ownJobColumns(jobs))
+    {
+        return -1;
+    }
+    int row;
+    if (jobs->freeCount > 0)
+    {
+        jobs->freeCount--;
+        row = jobs->freeRows[jobs->freeCount];
+    }
+    else
+    {
+        if (jobs->count == jobs->capacity)
+        {
+            if (jobs->capacity > INT_MAX / 2)
+            {
+                return -1;
+            }
+            if (!growJobTable(jobs, jobs->capacity > 0 ? jobs->capacity * 2 : JOB_TABLE_INITIAL_CAPACITY))
+            {
+                return -1;
+            }
+        }
+        row = jobs->count;
+        jobs->count++;
+    }
+    jobs->sequence[row] = sequence;
+    jobs->arrivalTime[row] = arrivalTime;
+    jobs->burstTime[row] = burstTime;
+    jobs->backUpBurstTime[row] = burstTime;
+    jobs->added++;
+    return row;
+}
+
+static void releaseJobRow(jobTable *jobs, int row)
+{
+    // The completed process no longer needs its row, it is reset for the next appended process
+    jobs->waitingTime[row] = 0;
+    jobs->responseTime[row] = -1;
+    jobs->queueLevel[row] = 0;
+    jobs->dispatchCount[row] = 0;
+    clearFlag(jobs->hasArrived, row);
+    clearFlag(jobs->hasCompleted, row);
+    clearFlag(jobs->inQueue, row);
+    jobs->freeRows[jobs->freeCount] = row;
+    jobs->freeCount++;
+}
+
+static void freeJobTable(jobTable *jobs)
+{
+    if (!jobs->borrowedColumns)
+    {
+        free(jobs->arrivalTime);
+        free(jobs->burstTime);
+    }
+    free(jobs->sequence);
+    free(jobs->backUpBurstTime);
+    free(jobs->waitingTime);
+    free(jobs->responseTime);
+    free(jobs->readySince);
+    free(jobs->queueLevel);
+    free(jobs->dispatchCount);
+    free(jobs->priority);
+    free(jobs->group);
+    free(jobs->hasArrived);
+    free(jobs->hasCompleted);
+    free(jobs->inQueue);
+    free(jobs->freeRows);
+}
+
+static void initCompletedTable(completedTable *completed)
+{
+    completed->count = 0;
+    completed->capacity = 0;
+    completed->fileID = NULL;
+    completed->waitingTime = NULL;
+    completed->turnAroundTime = NULL;
+    completed->responseTime = NULL;
+    completed->completionTime = NULL;
+    completed->dispatches = NULL;
+    completed->priority = NULL;
+    completed->group = NULL;
+}
+
+static bool growCompletedTable(completedTable *completed)
+{
+    // Doubles the columns of retained completions
+    int capacity = completed->capacity > 0 ? completed->capacity * 2 : JOB_TABLE_INITIAL_CAPACITY;
+    if (completed->capacity > INT_MAX / 2)
+    {
+        return false;
+    }
+    GROW_JOB_COLUMN(completed->fileID, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->waitingTime, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->turnAroundTime, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->responseTime, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->completionTime, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->dispatches, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->priority, completed->capacity, capacity, sizeof(int));
+    GROW_JOB_COLUMN(completed->group, completed->capacity, capacity, sizeof(int));
+    completed->capacity = capacity;
+    return true;
+}
+
+static void freeCompletedTable(completedTable *completed)
+{
+    free(completed->fileID);
+    free(completed->waitingTime);
+    free(completed->turnAroundTime);
+    free(completed->responseTime);
+    free(completed->completionTime);
+    free(completed->dispatches);
+    free(completed->priority);
+    free(completed->group);
+}
+
+static bool recordCompletion(scheduler *s, int fid)
+{
+    // Accounts a completed process in the running totals, keeps it if asked to and hands it to the callback
+    jobTable *jobs = &s->jobs;
+    schedulerCompletion completion;
+    completion.process = jobs->sequence[fid];
+    completion.arrivalTime = jobs->arrivalTime[fid];
+    completion.burstTime = jobs->burstTime[fid];
+    completion.completionTime = s->timeElapsed;
+    completion.waitingTime = jobs->waitingTime[fid];
+    completion.turnAroundTime = jobs->burstTime[fid] + jobs->waitingTime[fid];
+    completion.responseTime = jobs->responseTime[fid];
+    completion.dispatches = jobs->dispatchCount[fid];
+    completion.priority = jobs->priority[fid];
+    completion.group = jobs->group[fid];
+
+    completionSummary *summary = &s->summary;
+    if (!s->options.retainCompletions)
+    {
+        // Retained completions are reduced column by column when the results are asked for
+        if (summary->count == 0 || summary->maxWaitingTime < completion.waitingTime)
+        {
+            summary->maxWaitingTime = completion.waitingTime;
+        }
+        if (summary->count == 0 || summary->minWaitingTime > completion.waitingTime)
+        {
+            summary->minWaitingTime = completion.waitingTime;
+        }
+        if (summary->count == 0 || summary->maxTurnAroundTime < completion.turnAroundTime)
+        {
+            summary->maxTurnAroundTime = completion.turnAroundTime;
+        }
+        if (summary->count == 0 || summary->minTurnAroundTime > completion.turnAroundTime)
+        {
+            summary->minTurnAroundTime = completion.turnAroundTime;
+        }
+        summary->totalWaitingTime += completion.waitingTime;
+        summary->totalTurnAroundTime += completion.turnAroundTime;
+        summary->totalResponseTime += completion.responseTime;
+        summary->totalDispatches += completion.dispatches;
+        if (summary->maxDispatches < completion.dispatches)
+        {
+            summary->maxDispatches = completion.dispatches;
+        }
+    }
+    SchedulerHistogramAdd(&s->histograms[SCHEDULER_METRIC_WAITING_TIME], completion.waitingTime);
+    SchedulerHistogramAdd(&s->histograms[SCHEDULER_METRIC_TURNAROUND_TIME], completion.turnAroundTime);
+    SchedulerHistogramAdd(&s->histograms[SCHEDULER_METRIC_RESPONSE_TIME], completion.responseTime);
+    summary->count++;
+    addClassCompletion(&s->priorities[completion.priority], &completion);
+    addClassCompletion(&s->groups[completion.group], &completion);
+
+    if (s->options.retainCompletions)
+    {
+        completedTable *completed = &s->completed;
+        if (completed->count == completed->capacity && !growCompletedTable(completed))
+        {
+            return false;
+        }
+        int row = completed->count;
+        completed->fileID[row] = completion.process;
+        completed->waitingTime[row] = completion.waitingTime;
+        completed->turnAroundTime[row] = completion.turnAroundTime;
+        completed->responseTime[row] = completion.responseTime;
+        completed->completionTime[row] = completion.completionTime;
+        completed->dispatches[row] = completion.dispatches;
+        completed->priority[row] = completion.priority;
+        completed->group[row] = completion.group;
+        completed->count++;
+    }
+    if (s->options.onCompletion != NULL)
+    {
+        s->options.onCompletion(s->options.callbackContext, &completion);
+    }
+    return true;
+}
+
+static void reduceCompletedTable(const completedTable *completed, completionSummary *summary)
+{
+    // Totals, minima and maxima of the retained completions, one fused pass over each column
+    columnReduction waiting;
+    columnReduction turnAround;
+    columnReduction response;
+    columnReduction dispatches;
+    ReduceColumn(completed->waitingTime, completed->count, &waiting);
+    ReduceColumn(completed->turnAroundTime, completed->count, &turnAround);
+    ReduceColumn(completed->responseTime, completed->count, &response);
+    ReduceColumn(completed->dispatches, completed->count, &dispatches);
+    summary->totalWaitingTime = waiting.sum;
+    summary->maxWaitingTime = waiting.max;
+    summary->minWaitingTime = waiting.min;
+    summary->totalTurnAroundTime = turnAround.sum;
+    summary->maxTurnAroundTime = turnAround.max;
+    summary->minTurnAroundTime = turnAround.min;
+    summary->totalResponseTime = response.sum;
+    summary->totalDispatches = dispatches.sum;
+    summary->maxDispatches = dispatches.max;
+}
+
+static void printFileTable(jobTable *jobs)
+{
+    // Helper function to check contents of file table
+    printf("\t\tFID\tArrival Time\tBurst Time\tWaiting Time\t BackUp BurstTime\tResponse Time\n");
+    for (int i = 0; i < jobs->count; i++)
+    {
+        printf("Filetable[%i]:\t%i\t%i\t\t%i\t\t%i\t\t %i\t\t\t%i\n", i, jobs->sequence[i], jobs->arrivalTime[i], jobs->burstTime[i], jobs->waitingTime[i], jobs->backUpBurstTime[i], jobs->responseTime[i]);
+    }
+    printf("\n");
+}
+
+static void printReadyQueueEntries(readyQueueList *readyQueue, jobTable *jobs)
+{
+    // Helper function to display ready queue entries, mainly for debugging and report
+    readyQueueNode *temp = readyQueue->head;
+    if (CountUncompletedProcessesInQueue(readyQueue) == 0)
+    {
+        printf("Queue currently empty\n");
+    }
+    printf("Ready: %i\tRunning: %i\tCompleted: %i\n", GetReadyProcessCount(readyQueue), GetRunningProcessCount(readyQueue), GetCompletedProcessCount(readyQueue));
+    printf("Ready Queue\tArrival Time\tBurst Time\tWaiting Time\tBackUp BurstTime\tCompleted\tResponse time\n");
+    while (temp != NULL)
+    {
+        int fid = temp->fileID;
+        printf("\t\t%i\t\t%i\t\t%i\t\t%i\t\t\t%d\t\t%i\n", jobs->arrivalTime[fid], jobs->burstTime[fid], jobs->waitingTime[fid], jobs->backUpBurstTime[fid], testFlag(jobs->hasCompleted, fid), jobs->responseTime[fid]);
+        temp = temp->next;
+    }
+    printf("\n");
+}
+
+static schedulerStatus DispatchTimeSlice(scheduler *s, cpuState *cpu)
+{
+    // Gives an idle CPU its next time slice, the policy decides which process and for how long
+    // Event driven: the time slice is not stepped 1 unit at a time, it ends at cpu->sliceEnd
+    // (end of the time slice or completion) where finishTimeSlice accounts for it at once.
+    readyQueueList *readyQueue = &cpu->readyQueue;
+    if (CountUncompletedProcessesInQueue(readyQueue) == 0 && !stealReadyProcess(s, cpu))
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    if (CountUncompletedProcessesInQueue(readyQueue) == 0)
+    {
+        // CPU idle until a process arrives or another CPU has one to steal
+        return SCHEDULER_OK;
+    }
+
+    // Process first in the policy's order, the process holding the CPU is requeued (preempted) if it is not the one
+    // Switching to a different process takes options.switchCost before it starts running, it waits meanwhile
+    PROFILE_BEGIN(select);
+    readyQueueNode *temp = isFairShare(s) ? getNextFairShareProcess(s, cpu) : getNextProcess(&cpu->heap);
+    PROFILE_END(select, SCHEDULER_PHASE_SELECT);
+    int start = s->timeElapsed;
+    if (isFairShare(s))
+    {
+        dequeueWaiting(getClassQueue(s, cpu, temp->fileID), temp);
+        s->virtualTime = s->groupVirtualTime[s->jobs.group[temp->fileID]];
+    }
+    if (readyQueue->runningNode != temp)
+    {
+        s->contextSwitches++;
+        if (readyQueue->runningNode != NULL)
+        {
+            s->preemptions++;
+        }
+        s->jobs.dispatchCount[temp->fileID]++;
+        start += s->options.switchCost;
+        cpu->switchTime += s->options.switchCost;
+    }
+    PROFILE_BEGIN(settle);
+    DispatchFromReadyQueue(temp, readyQueue, &s->jobs, start);
+    PROFILE_END(settle, SCHEDULER_PHASE_SETTLE);
+    cpu->slice = temp;
+    cpu->sliceQuantum = 0;
+    cpu->sliceDispatched = s->timeElapsed;
+    cpu->sliceLength = s->policy->timeSlice(s, cpu, temp->fileID);
+    cpu->sliceEnd = start + cpu->sliceLength;
+    return SCHEDULER_OK;
+}
+
+static int mergedTimeQuantum(scheduler *s, cpuState *cpu, int fid, int timeQuantum)
+{
+    // Time slice of a process that is alone in its ready queue: a single time quantum (or less to completion)
+    // Nothing else can be scheduled until a new process arrives, so consecutive time quantums are
+    // merged up to the first quantum boundary at or after the next arrival (or until completion)
+    cpu->sliceQuantum = timeQuantum;
+    int remaining = s->jobs.backUpBurstTime[fid];
+    int nextArrival = getNextArrivalTime(&s->arrivals);
+    if (timeQuantum >= remaining || nextArrival == -1)
+    {
+        return remaining;
+    }
+    long long quantums = (nextArrival - s->timeElapsed + timeQuantum - 1) / timeQuantum;
+    if (quantums < 1)
+    {
+        quantums = 1;
+    }
+    return quantums * timeQuantum < remaining ? (int)(quantums * timeQuantum) : remaining;
+}
+
+static void cutSlicesAtArrival(scheduler *s)
+{
+    // Only a context restored from a snapshot has time slices before its first step. Processes added since may
+    // arrive before the end of a slice that was sized by the arrivals known when it was decided, that slice
+    // now ends where it would have ended had they been known, at the first multiple of its quantum after the arrival
+    int nextArrival = getNextArrivalTime(&s->arrivals);
+    for (int c = 0; c < s->options.cpuCount && nextArrival != -1; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        if (cpu->slice == NULL || cpu->sliceQuantum == 0 || nextArrival >= cpu->sliceEnd)
+        {
+            continue;
+        }
+        long long quantums = ((long long)nextArrival - cpu->sliceDispatched + cpu->sliceQuantum - 1) / cpu->sliceQuantum;
+        if (quantums < 1)
+        {
+            quantums = 1;
+        }
+        long long sliceEnd = cpu->sliceDispatched + quantums * cpu->sliceQuantum + (cpu->sliceEnd - cpu->sliceLength - cpu->sliceDispatched);
+        if (sliceEnd < cpu->sliceEnd)
+        {
+            cpu->sliceLength -= cpu->sliceEnd - (int)sliceEnd;
+            cpu->sliceEnd = (int)sliceEnd;
+        }
+    }
+}
+
+static int HybridRoundRobin(scheduler *s, cpuState *cpu, int fid)
+{
+    // Time quantum here is dynamic and changes according to remaining burst time of process
+    // Employs dynamic time quantum in RR and SJF whenever possible
+    // Only 1 uncompleted process: RR with the time quantum, lowered to its remaining burst time
+    // More than 1 process in queue: the one with lowest remaining burst time was dispatched (SJF), it runs to completion
+    if (CountUncompletedProcessesInQueue(&cpu->readyQueue) == 1)
+    {
+        return mergedTimeQuantum(s, cpu, fid, s->timeQuantum);
+    }
+    return s->jobs.backUpBurstTime[fid];
+}
+
+static int runToCompletion(scheduler *s, cpuState *cpu, int fid)
+{
+    // FCFS and SJF are non-preemptive
+    return s->jobs.backUpBurstTime[fid];
+}
+
+static int roundRobinTimeSlice(scheduler *s, cpuState *cpu, int fid)
+{
+    // Fixed time quantum, the process then goes to the back of the ready queue
+    int remaining = s->jobs.backUpBurstTime[fid];
+    if (CountUncompletedProcessesInQueue(&cpu->readyQueue) == 1)
+    {
+        return mergedTimeQuantum(s, cpu, fid, s->timeQuantum);
+    }
+    return s->timeQuantum < remaining ? s->timeQuantum : remaining;
+}
+
+static int shortestRemainingTimeSlice(scheduler *s, cpuState *cpu, int fid)
+{
+    // Runs until completion or the next arrival, which may preempt it with a shorter remaining burst time
+    cpu->sliceQuantum = 1;
+    int remaining = s->jobs.backUpBurstTime[fid];
+    int nextArrival = getNextArrivalTime(&s->arrivals);
+    if (nextArrival != -1 && nextArrival - s->timeElapsed < remaining)
+    {
+        return nextArrival - s->timeElapsed;
+    }
+    return remaining;
+}
+
+static int multilevelFeedbackTimeSlice(scheduler *s, cpuState *cpu, int fid)
+{
+    // Time quantum doubles with every level, the lowest level runs processes to completion (FCFS)
+    int remaining = s->jobs.backUpBurstTime[fid];
+    int level = s->jobs.queueLevel[fid];
+    if (level == MLFQ_LEVELS - 1)
+    {
+        return remaining;
+    }
+    int timeQuantum = s->timeQuantum << level;
+    return timeQuantum < remaining ? timeQuantum : remaining;
+}
+
+static void multilevelFeedbackDemote(scheduler *s, int fid, int sliceLength)
+{
+    // Used its whole time quantum, so it moves one level down
+    if (s->jobs.queueLevel[fid] < MLFQ_LEVELS - 1)
+    {
+        s->jobs.queueLevel[fid]++;
+    }
+}
+
+static readyQueueNode *getNextFairShareProcess(scheduler *s, cpuState *cpu)
+{
+    // Group with the lowest virtual time (root of the group tree, O(1)), then its highest priority class with
+    // processes, dispatched in hybrid RR + SJF order. Aging lowers the level of a class by one per agingInterval
+    // its oldest process has waited; a class that overtakes a higher one that way runs its oldest process
+    int group = cpu->groupTree[1];
+    classQueue *classes = &cpu->classes[group * SCHEDULER_PRIORITY_LEVELS];
+    int highest = -1;
+    int chosen = -1;
+    long long chosenLevel = 0;
+    for (int level = 0; level < SCHEDULER_PRIORITY_LEVELS; level++)
+    {
+        classQueue *queue = &classes[level];
+        PROFILE_VISIT(1);
+        if (queue->heap.size == 0)
+        {
+            continue;
+        }
+        if (highest == -1)
+        {
+            highest = level;
+        }
+        long long effective = level;
+        if (s->options.agingInterval > 0)
+        {
+            effective -= (s->timeElapsed - s->jobs.readySince[queue->oldest->fileID]) / s->options.agingInterval;
+        }
+        if (chosen == -1 || effective < chosenLevel ||
+            (effective == chosenLevel && isLowerReadySince(&s->jobs, queue->oldest->fileID, classes[chosen].oldest->fileID)))
+        {
+            chosen = level;
+            chosenLevel = effective;
+        }
+    }
+    if (chosen == highest)
+    {
+        return getNextProcess(&classes[chosen].heap);
+    }
+    return classes[chosen].oldest;
+}
+
+static readyQueueNode *getOldestStealableProcess(scheduler *s, cpuState *victim)
+{
+    // Oldest waiting process over every class of the victim, other than the one holding its CPU
+    readyQueueNode *oldest = NULL;
+    for (int i = 0; i < s->options.groupCount * SCHEDULER_PRIORITY_LEVELS; i++)
+    {
+        readyQueueNode *node = victim->classes[i].oldest;
+        if (node != NULL && node == victim->readyQueue.runningNode)
+        {
+            node = node->olderNext;
+        }
+        if (node != NULL && (oldest == NULL || isLowerReadySince(&s->jobs, node->fileID, oldest->fileID)))
+        {
+            oldest = node;
+        }
+    }
+    return oldest;
+}
+
+static void chargeFairShare(scheduler *s, int fid, int sliceLength)
+{
+    // The group of the process advances its virtual time by the time slice over its weight
+    // Its position in the group tree of every CPU changes with it, O(cpus * log groups)
+    int group = s->jobs.group[fid];
+    int weight = s->options.groupWeights != NULL ? s->options.groupWeights[group] : 1;
+    s->groupVirtualTime[group] += (double)sliceLength / weight;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        updateGroupTree(s, &s->cpus[c], group);
+    }
+}
+
+static void activateGroup(scheduler *s, int group)
+{
+    // A group with nothing in flight gets no credit for the time it was idle, it resumes at the current virtual time
+    if (s->groupVirtualTime[group] < s->virtualTime)
+    {
+        s->groupVirtualTime[group] = s->virtualTime;
+    }
+}
+
+static bool isFairShare(const scheduler *s)
+{
+    return s->options.policy == SCHEDULER_POLICY_FAIR_SHARE;
+}
+
+static readyQueueHeap *getReadyHeap(scheduler *s, cpuState *cpu, int fid)
+{
+    // Heap a process of this CPU is ordered in
+    return isFairShare(s) ? &getClassQueue(s, cpu, fid)->heap : &cpu->heap;
+}
+
+static classQueue *getClassQueue(scheduler *s, cpuState *cpu, int fid)
+{
+    return &cpu->classes[s->jobs.group[fid] * SCHEDULER_PRIORITY_LEVELS + s->jobs.priority[fid]];
+}
+
+static void enqueueWaiting(classQueue *queue, readyQueueNode *node)
+{
+    // Inserts node by the time it became ready, processes become ready in time order so this is usually at the back,
+    // only a stolen process walks forward to its place
+    const jobTable *jobs = queue->heap.jobs;
+    readyQueueNode *older = queue->newest;
+    while (older != NULL && isLowerReadySince(jobs, node->fileID, older->fileID))
+    {
+        older = older->olderPrev;
+    }
+    node->olderPrev = older;
+    node->olderNext = older != NULL ? older->olderNext : queue->oldest;
+    if (node->olderNext != NULL)
+    {
+        node->olderNext->olderPrev = node;
+    }
+    else
+    {
+        queue->newest = node;
+    }
+    if (older != NULL)
+    {
+        older->olderNext = node;
+    }
+    else
+    {
+        queue->oldest = node;
+    }
+    node->waiting = true;
+}
+
+static void dequeueWaiting(classQueue *queue, readyQueueNode *node)
+{
+    if (!node->waiting)
+    {
+        return;
+    }
+    if (node->olderPrev == NULL)
+    {
+        queue->oldest = node->olderNext;
+    }
+    else
+    {
+        node->olderPrev->olderNext = node->olderNext;
+    }
+    if (node->olderNext == NULL)
+    {
+        queue->newest = node->olderPrev;
+    }
+    else
+    {
+        node->olderNext->olderPrev = node->olderPrev;
+    }
+    node->waiting = false;
+}
+
+static void updateGroupTree(scheduler *s, cpuState *cpu, int group)
+{
+    // Replays the matches on the path from the leaf of group to the root, O(log groups)
+    if (cpu->groupTree == NULL)
+    {
+        return;
+    }
+    int size = 0;
+    for (int level = 0; level < SCHEDULER_PRIORITY_LEVELS; level++)
+    {
+        size += cpu->classes[group * SCHEDULER_PRIORITY_LEVELS + level].heap.size;
+    }
+    int i = s->groupTreeLeaves + group;
+    cpu->groupTree[i] = size > 0 ? group : -1;
+    for (i /= 2; i >= 1; i /= 2)
+    {
+        cpu->groupTree[i] = getLowerVirtualTimeGroup(s, cpu->groupTree[2 * i], cpu->groupTree[2 * i + 1]);
+    }
+}
+
+static int getLowerVirtualTimeGroup(const scheduler *s, int a, int b)
+{
+    // Winner of one match of the group tree, -1 for a side without processes, ties go to the lower group
+    if (a == -1)
+    {
+        return b;
+    }
+    if (b == -1)
+    {
+        return a;
+    }
+    return s->groupVirtualTime[b] < s->groupVirtualTime[a] ? b : a;
+}
+
+static void addClassCompletion(classSummary *summary, const schedulerCompletion *completion)
+{
+    if (summary->count == 0 || summary->maxWaitingTime < completion->waitingTime)
+    {
+        summary->maxWaitingTime = completion->waitingTime;
+    }
+    if (summary->count == 0 || summary->maxTurnAroundTime < completion->turnAroundTime)
+    {
+        summary->maxTurnAroundTime = completion->turnAroundTime;
+    }
+    summary->totalWaitingTime += completion->waitingTime;
+    summary->totalTurnAroundTime += completion->turnAroundTime;
+    summary->count++;
+}
+
+static void getClassStats(const classSummary *summary, schedulerClassStats *stats)
+{
+    // Averages are 0 for a class without completed processes
+    stats->completed = summary->count;
+    stats->averageWaitingTime = summary->count > 0 ? (float)(summary->totalWaitingTime / summary->count) : 0.0f;
+    stats->averageTurnaroundTime = summary->count > 0 ? (float)(summary->totalTurnAroundTime / summary->count) : 0.0f;
+    stats->maxWaitingTime = summary->maxWaitingTime;
+    stats->maxTurnaroundTime = summary->maxTurnAroundTime;
+    stats->serviceTime = summary->serviceTime;
+}
+
+static bool writeSnapshotBlock(FILE *fp, const void *data, size_t count, size_t size)
+{
+    return count == 0 || fwrite(data, size, count, fp) == count;
+}
+
+static bool readSnapshotBlock(FILE *fp, void *data, size_t count, size_t size)
+{
+    return count == 0 || fread(data, size, count, fp) == count;
+}
+
+static void getSnapshotColumns(const scheduler *s, int **jobColumns, int **completedColumns)
+{
+    // Columns in the order they are saved, SNAPSHOT_JOB_COLUMNS and SNAPSHOT_COMPLETED_COLUMNS of them
+    const jobTable *jobs = &s->jobs;
+    const completedTable *completed = &s->completed;
+    int *jobTableColumns[SNAPSHOT_JOB_COLUMNS] = {
+        jobs->sequence, jobs->arrivalTime, jobs->burstTime, jobs->backUpBurstTime, jobs->waitingTime, jobs->responseTime,
+        jobs->readySince, jobs->queueLevel, jobs->dispatchCount, jobs->priority, jobs->group};
+    int *completedTableColumns[SNAPSHOT_COMPLETED_COLUMNS] = {
+        completed->fileID, completed->waitingTime, completed->turnAroundTime, completed->responseTime,
+        completed->completionTime, completed->dispatches, completed->priority, completed->group};
+    memcpy(jobColumns, jobTableColumns, sizeof(jobTableColumns));
+    memcpy(completedColumns, completedTableColumns, sizeof(completedTableColumns));
+}
+
+static schedulerStatus restoreSnapshot(scheduler *s, FILE *fp, const snapshotState *state)
+{
+    // Reads everything after the options into a new context created with them
+    int groupCount = s->options.groupCount;
+    if (state->jobCount < 0 || state->jobCount > INT_MAX / 2 || state->jobsAdded < state->jobCount ||
+        state->freeCount < 0 || state->freeCount > state->jobCount || state->completedCount < 0 ||
+        state->pendingCount < 0 || state->pendingCount > state->jobCount || state->inFlight < 0)
+    {
+        return SCHEDULER_IO_ERROR;
+    }
+    s->timeQuantum = state->timeQuantum;
+    s->timeElapsed = state->timeElapsed;
+    s->inFlight = state->inFlight;
+    s->contextSwitches = state->contextSwitches;
+    s->preemptions = state->preemptions;
+    s->events = state->events;
+    s->virtualTime = state->virtualTime;
+    if (!readSnapshotBlock(fp, &s->bursts, 1, sizeof(burstStatistics)) ||
+        !readSnapshotBlock(fp, &s->summary, 1, sizeof(completionSummary)) ||
+        !readSnapshotBlock(fp, s->histograms, SCHEDULER_METRIC_COUNT, sizeof(schedulerHistogram)) ||
+        !readSnapshotBlock(fp, s->priorities, SCHEDULER_PRIORITY_LEVELS, sizeof(classSummary)) ||
+        !readSnapshotBlock(fp, s->groups, groupCount, sizeof(classSummary)) ||
+        !readSnapshotBlock(fp, s->groupVirtualTime, groupCount, sizeof(double)) ||
+        !readSnapshotBlock(fp, s->groupInFlight, groupCount, sizeof(int)))
+    {
+        return SCHEDULER_IO_ERROR;
+    }
+
+    // Tables are allocated to the saved size, then read column by column
+    jobTable *jobs = &s->jobs;
+    completedTable *completed = &s->completed;
+    if (!growJobTable(jobs, state->jobCount > 0 ? state->jobCount : 1))
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    while (completed->capacity < state->completedCount)
+    {
+        if (!growCompletedTable(completed))
+        {
+            return SCHEDULER_OUT_OF_MEMORY;
+        }
+    }
+    int *jobColumns[SNAPSHOT_JOB_COLUMNS];
+    int *completedColumns[SNAPSHOT_COMPLETED_COLUMNS];
+    getSnapshotColumns(s, jobColumns, completedColumns);
+    for (int c = 0; c < SNAPSHOT_JOB_COLUMNS; c++)
+    {
+        if (!readSnapshotBlock(fp, jobColumns[c], state->jobCount, sizeof(int)))
+        {
+            return SCHEDULER_IO_ERROR;
+        }
+    }
+    for (int c = 0; c < SNAPSHOT_COMPLETED_COLUMNS; c++)
+    {
+        if (!readSnapshotBlock(fp, completedColumns[c], state->completedCount, sizeof(int)))
+        {
+            return SCHEDULER_IO_ERROR;
+        }
+    }
+    int words = (state->jobCount + FLAG_WORD_BITS - 1) / FLAG_WORD_BITS;
+    if (!readSnapshotBlock(fp, jobs->hasArrived, words, sizeof(flagWord)) ||
+        !readSnapshotBlock(fp, jobs->hasCompleted, words, sizeof(flagWord)) ||
+        !readSnapshotBlock(fp, jobs->inQueue, words, sizeof(flagWord)) ||
+        !readSnapshotBlock(fp, jobs->freeRows, state->freeCount, sizeof(int)))
+    {
+        return SCHEDULER_IO_ERROR;
+    }
+    jobs->count = state->jobCount;
+    jobs->added = state->jobsAdded;
+    jobs->freeCount = state->freeCount;
+    completed->count = state->completedCount;
+    for (int i = 0; i < jobs->count; i++)
+    {
+        if (jobs->priority[i] < 0 || jobs->priority[i] >= SCHEDULER_PRIORITY_LEVELS || jobs->group[i] < 0 || jobs->group[i] >= groupCount)
+        {
+            return SCHEDULER_IO_ERROR;
+        }
+    }
+
+    for (int i = 0; i < state->pendingCount; i++)
+    {
+        arrivalEntry entry;
+        if (!readSnapshotBlock(fp, &entry, 1, sizeof(entry)) || entry.fileID < 0 || entry.fileID >= jobs->count ||
+            entry.sequence != jobs->sequence[entry.fileID])
+        {
+            return SCHEDULER_IO_ERROR;
+        }
+        if (!pushArrival(&s->arrivals, entry.arrivalTime, entry.fileID, entry.sequence))
+        {
+            return SCHEDULER_OUT_OF_MEMORY;
+        }
+    }
+    s->arrivals.lastArrivalTime = state->lastArrivalTime;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        if (!restoreSnapshotCpu(s, &s->cpus[c], fp))
+        {
+            return SCHEDULER_IO_ERROR;
+        }
+    }
+
+    // Pending arrivals are sorted again on the next step, so processes added from here on may come in any order
+    s->started = false;
+    s->inputClosed = false;
+    s->earliestArrival = s->timeElapsed;
+    return SCHEDULER_OK;
+}
+
+static bool restoreSnapshotCpu(scheduler *s, cpuState *cpu, FILE *fp)
+{
+    // Relinks the ready queue in its saved order and pushes every node into the heap of the policy
+    // Heap orderings are total, so the rebuilt heaps dispatch exactly as the saved ones would have
+    snapshotCpu saved;
+    if (!readSnapshotBlock(fp, &saved, 1, sizeof(saved)) || saved.nodeCount < 0 ||
+        saved.running < -1 || saved.running >= saved.nodeCount || saved.slice < -1 || saved.slice >= saved.nodeCount)
+    {
+        return false;
+    }
+    readyQueueList *readyQueue = &cpu->readyQueue;
+    for (int i = 0; i < saved.nodeCount; i++)
+    {
+        snapshotNode entry;
+        if (!readSnapshotBlock(fp, &entry, 1, sizeof(entry)) || entry.fileID < 0 || entry.fileID >= s->jobs.count)
+        {
+            return false;
+        }
+        readyQueueNode *node = allocateReadyQueueNode(readyQueue);
+        if (node == NULL)
+        {
+            return false;
+        }
+        node->fileID = entry.fileID;
+        node->waiting = false;
+        if (!heapPush(getReadyHeap(s, cpu, entry.fileID), node))
+        {
+            return false;
+        }
+        LinkToReadyQueue(node, readyQueue);
+        if (isFairShare(s) && entry.waiting)
+        {
+            enqueueWaiting(getClassQueue(s, cpu, entry.fileID), node);
+        }
+        if (i == saved.running)
+        {
+            readyQueue->runningNode = node;
+        }
+        if (i == saved.slice)
+        {
+            cpu->slice = node;
+        }
+    }
+    cpu->busyTime = saved.busyTime;
+    cpu->switchTime = saved.switchTime;
+    cpu->migrations = saved.migrations;
+    cpu->sliceLength = saved.sliceLength;
+    cpu->sliceEnd = saved.sliceEnd;
+    cpu->sliceDispatched = saved.sliceDispatched;
+    cpu->sliceQuantum = saved.sliceQuantum;
+    readyQueue->processesAdded = saved.processesAdded;
+    readyQueue->readyCount = saved.readyCount;
+    readyQueue->runningCount = saved.runningCount;
+    readyQueue->completedCount = saved.completedCount;
+    s->cpuLoad[cpu - s->cpus] = CountUncompletedProcessesInQueue(readyQueue);
+    for (int group = 0; group < s->options.groupCount; group++)
+    {
+        updateGroupTree(s, cpu, group);
+    }
+    return true;
+}
+static bool isLowerRemainingBurstTime(const jobTable *jobs, int a, int b)
+{
+    // (remaining burst time, arrival time, fid), fid being the order of adding
+    if (jobs->backUpBurstTime[a] != jobs->backUpBurstTime[b])
+    {
+        return jobs->backUpBurstTime[a] < jobs->backUpBurstTime[b];
+    }
+    if (jobs->arrivalTime[a] != jobs->arrivalTime[b])
+    {
+        return jobs->arrivalTime[a] < jobs->arrivalTime[b];
+    }
+    return jobs->sequence[a] < jobs->sequence[b];
+}
+
+static bool isLowerArrivalTime(const jobTable *jobs, int a, int b)
+{
+    // (arrival time, fid)
+    if (jobs->arrivalTime[a] != jobs->arrivalTime[b])
+    {
+        return jobs->arrivalTime[a] < jobs->arrivalTime[b];
+    }
+    return jobs->sequence[a] < jobs->sequence[b];
+}
+
+static bool isLowerReadySince(const jobTable *jobs, int a, int b)
+{
+    // (time it entered the ready state, fid), i.e., a FIFO queue processes rejoin at the back
+    if (jobs->readySince[a] != jobs->readySince[b])
+    {
+        return jobs->readySince[a] < jobs->readySince[b];
+    }
+    return jobs->sequence[a] < jobs->sequence[b];
+}
+
+static bool isLowerQueueLevel(const jobTable *jobs, int a, int b)
+{
+    // (level, time it entered the ready state, fid), FIFO within a level
+    if (jobs->queueLevel[a] != jobs->queueLevel[b])
+    {
+        return jobs->queueLevel[a] < jobs->queueLevel[b];
+    }
+    return isLowerReadySince(jobs, a, b);
+}
+
+static bool finishTimeSlice(scheduler *s, cpuState *cpu)
+{
+    // Whole time slice is accounted for at once, waiting time was settled when the process was dispatched
+    // The process keeps the CPU (runningNode) until another is dispatched on it, false if out of memory
+    readyQueueNode *temp = cpu->slice;
+    jobTable *jobs = &s->jobs;
+    int fid = temp->fileID;
+    int group = jobs->group[fid];
+    jobs->backUpBurstTime[fid] -= cpu->sliceLength;
+    cpu->busyTime += cpu->sliceLength;
+    cpu->slice = NULL;
+    s->events++;
+    s->priorities[jobs->priority[fid]].serviceTime += cpu->sliceLength;
+    s->groups[group].serviceTime += cpu->sliceLength;
+    if (isFairShare(s))
+    {
+        chargeFairShare(s, fid, cpu->sliceLength);
+    }
+    if (s->options.onTimeSlice != NULL)
+    {
+        schedulerTimeSlice slice;
+        slice.cpu = (int)(cpu - s->cpus);
+        slice.process = jobs->sequence[fid];
+        slice.startTime = cpu->sliceEnd - cpu->sliceLength;
+        slice.endTime = cpu->sliceEnd;
+        s->options.onTimeSlice(s->options.callbackContext, &slice);
+    }
+
+    if (jobs->backUpBurstTime[fid] == 0)
+    {
+        setFlag(jobs->hasCompleted, fid);
+        heapRemove(getReadyHeap(s, cpu, fid), temp);
+        RemoveFromReadyQueue(temp, &cpu->readyQueue);
+        s->cpuLoad[cpu - s->cpus]--;
+        s->inFlight--;
+        if (isFairShare(s))
+        {
+            s->groupInFlight[group]--;
+            updateGroupTree(s, cpu, group);
+        }
+        if (!recordCompletion(s, fid))
+        {
+            return false;
+        }
+        releaseJobRow(jobs, fid);
+    }
+    else
+    {
+        // Back in the ready state unless dispatched again straight away
+        // remaining burst time decreased, restore its position in the heap
+        jobs->readySince[fid] = s->timeElapsed;
+        if (s->policy->endTimeSlice != NULL)
+        {
+            s->policy->endTimeSlice(s, fid, cpu->sliceLength);
+        }
+        heapUpdateKey(getReadyHeap(s, cpu, fid), temp);
+        if (isFairShare(s))
+        {
+            enqueueWaiting(getClassQueue(s, cpu, fid), temp);
+        }
+    }
+    return true;
+}
+
+static bool stealReadyProcess(scheduler *s, cpuState *thief)
+{
+    // Work stealing: a CPU with an empty ready queue takes the ready process that the CPU with the most ready
+    // processes would run next (lowest remaining burst time). A process holding a CPU is never taken.
+    // The process keeps waiting, it only moves to the ready queue of the thief. false if out of memory
+    cpuState *victim = NULL;
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        cpuState *cpu = &s->cpus[c];
+        if (cpu != thief && GetReadyProcessCount(&cpu->readyQueue) > 0 &&
+            (victim == NULL || GetReadyProcessCount(&cpu->readyQueue) > GetReadyProcessCount(&victim->readyQueue)))
+        {
+            victim = cpu;
+        }
+    }
+    if (victim == NULL)
+    {
+        return true;
+    }
+
+    readyQueueNode *node;
+    if (isFairShare(s))
+    {
+        // Classes have heaps of their own, the process that has waited longest is taken instead
+        node = getOldestStealableProcess(s, victim);
+        dequeueWaiting(getClassQueue(s, victim, node->fileID), node);
+    }
+    else
+    {
+        // Heap root unless that one holds the CPU, the next lowest is then one of its children
+        readyQueueHeap *heap = &victim->heap;
+        node = heap->nodes[0];
+        if (node == victim->readyQueue.runningNode)
+        {
+            node = heap->nodes[1];
+            if (heap->size > 2 && heapNodeIsLower(heap, heap->nodes[2], node))
+            {
+                node = heap->nodes[2];
+            }
+        }
+    }
+    int fid = node->fileID;
+    heapRemove(getReadyHeap(s, victim, fid), node);
+    UnlinkFromReadyQueue(node, &victim->readyQueue);
+    victim->readyQueue.readyCount--;
+    s->cpuLoad[victim - s->cpus]--;
+    if (!heapPush(getReadyHeap(s, thief, fid), node))
+    {
+        return false;
+    }
+    LinkToReadyQueue(node, &thief->readyQueue);
+    thief->readyQueue.readyCount++;
+    s->cpuLoad[thief - s->cpus]++;
+    thief->migrations++;
+    if (isFairShare(s))
+    {
+        enqueueWaiting(getClassQueue(s, thief, fid), node);
+        updateGroupTree(s, victim, s->jobs.group[fid]);
+        updateGroupTree(s, thief, s->jobs.group[fid]);
+    }
+    return true;
+}
+
+static void reclaimFreeNodes(scheduler *s, cpuState *cpu)
+{
+    // A stolen process frees its node on the thief, so the CPUs processes arrive on would keep allocating slabs
+    // while the free nodes pile up elsewhere. Before a CPU allocates a new slab it takes the free nodes of another
+    // CPU, which keeps the nodes allocated bounded by the processes in flight rather than by the steals
+    readyQueueList *readyQueue = &cpu->readyQueue;
+    if (readyQueue->freeNodes != NULL || readyQueue->slabNodesUsed < READY_QUEUE_SLAB_SIZE)
+    {
+        return;
+    }
+    for (int c = 0; c < s->options.cpuCount; c++)
+    {
+        readyQueueList *other = &s->cpus[c].readyQueue;
+        if (other->freeNodes != NULL)
+        {
+            readyQueue->freeNodes = other->freeNodes;
+            other->freeNodes = NULL;
+            return;
+        }
+    }
+}
+
+static bool pushArrival(arrivalCursor *arrivals, int arrivalTime, int fileID, int sequence)
+{
+    // Queues an added process for admission, the space of admitted entries is reclaimed first
+    if (arrivals->next == arrivals->count)
+    {
+        arrivals->next = 0;
+        arrivals->count = 0;
+    }
+    if (arrivals->count == arrivals->capacity)
+    {
+        if (arrivals->next > 0)
+        {
+            memmove(arrivals->order, arrivals->order + arrivals->next, (arrivals->count - arrivals->next) * sizeof(arrivalEntry));
+            arrivals->count -= arrivals->next;
+            arrivals->next = 0;
+        }
+        else
+        {
+            if (arrivals->capacity > INT_MAX / 2)
+            {
+                return false;
+            }
+            int capacity = arrivals->capacity > 0 ? arrivals->capacity * 2 : JOB_TABLE_INITIAL_CAPACITY;
+            arrivalEntry *order = reallocateColumn(arrivals->order, arrivals->capacity, capacity, sizeof(arrivalEntry));
+            if (order == NULL)
+            {
+                return false;
+            }
+            arrivals->order = order;
+            arrivals->capacity = capacity;
+        }
+    }
+    arrivals->order[arrivals->count].arrivalTime = arrivalTime;
+    arrivals->order[arrivals->count].fileID = fileID;
+    arrivals->order[arrivals->count].sequence = sequence;
+    arrivals->count++;
+    if (arrivals->lastArrivalTime < arrivalTime)
+    {
+        arrivals->lastArrivalTime = arrivalTime;
+    }
+    return true;
+}
+
+static int getNextArrivalTime(arrivalCursor *arrivals)
+{
+    // Returns earliest arrival time of processes not yet added to the ready queue, -1 if all have arrived
+    if (arrivals->next == arrivals->count)
+    {
+        return -1;
+    }
+    return arrivals->order[arrivals->next].arrivalTime;
+}
+
+static int compareArrivalEntries(const void *a, const void *b)
+{
+    // qsort comparator, orders by arrival time then sequence (FIFO)
+    const arrivalEntry *x = a;
+    const arrivalEntry *y = b;
+    if (x->arrivalTime != y->arrivalTime)
+    {
+        return x->arrivalTime < y->arrivalTime ? -1 : 1;
+    }
+    return (x->sequence > y->sequence) - (x->sequence < y->sequence);
+}
+
+static bool populateQueueIfArrive(scheduler *s)
+{
+    // Populates ready queue by invoking AddToReadyQueue
+    // Processes are visited in arrival order, so this stops at the first one that has not arrived yet
+    // With an adaptive time quantum the burst time statistics are updated, then the time quantum once
+    arrivalCursor *arrivals = &s->arrivals;
+    jobTable *jobs = &s->jobs;
+    bool admitted = false;
+    while (arrivals->next < arrivals->count && arrivals->order[arrivals->next].arrivalTime <= s->timeElapsed)
+    {
+        // File has arrived and is not yet in queue, i.e., add to queue
+        // time elapsed may have jumped past its arrival, it is still deemed added at its arrival time
+        int i = arrivals->order[arrivals->next].fileID;
+        cpuState *cpu = getLeastLoadedCpu(s);
+        reclaimFreeNodes(s, cpu);
+        jobs->readySince[i] = jobs->arrivalTime[i]; // set before the heap orders it
+        PROFILE_VISIT(1);
+        PROFILE_BEGIN(enqueue);
+        bool added = AddToReadyQueue(i, &cpu->readyQueue, getReadyHeap(s, cpu, i));
+        PROFILE_END(enqueue, SCHEDULER_PHASE_ENQUEUE);
+        if (!added)
+        {
+            return false;
+        }
+        s->cpuLoad[cpu - s->cpus]++;
+        if (isFairShare(s))
+        {
+            int group = jobs->group[i];
+            if (s->groupInFlight[group] == 0)
+            {
+                activateGroup(s, group);
+            }
+            s->groupInFlight[group]++;
+            enqueueWaiting(getClassQueue(s, cpu, i), cpu->readyQueue.tail);
+            updateGroupTree(s, cpu, group);
+        }
+        s->inFlight++;
+        setFlag(jobs->hasArrived, i);
+        setFlag(jobs->inQueue, i);
+        arrivals->next++;
+        s->events++;
+        admitted = true;
+        if (s->options.quantumMode != SCHEDULER_QUANTUM_FIXED)
+        {
+            addBurstTime(&s->bursts, jobs->burstTime[i]);
+        }
+    }
+    if (admitted && s->options.quantumMode != SCHEDULER_QUANTUM_FIXED)
+    {
+        s->timeQuantum = getAdaptiveTimeQuantum(s);
+    }
+    return true;
+}
+
+static int getHistogramBucket(int value)
+{
+    // Log-linear bucket of a time: exact below HISTOGRAM_EXACT_BUCKETS, then HISTOGRAM_BUCKETS_PER_POWER per power of two
+    if (value < HISTOGRAM_EXACT_BUCKETS)
+    {
+        return value;
+    }
+    int exponent = 0;
+    while ((value >> exponent) > 1)
+    {
+        exponent++;
+    }
+    int mantissa = (value >> (exponent - 3)) & (HISTOGRAM_BUCKETS_PER_POWER - 1);
+    return HISTOGRAM_EXACT_BUCKETS + (exponent - 4) * HISTOGRAM_BUCKETS_PER_POWER + mantissa;
+}
+
+static int getHistogramBucketLimit(int bucket)
+{
+    // Largest time that falls into bucket
+    if (bucket < HISTOGRAM_EXACT_BUCKETS)
+    {
+        return bucket;
+    }
+    int exponent = 4 + (bucket - HISTOGRAM_EXACT_BUCKETS) / HISTOGRAM_BUCKETS_PER_POWER;
+    int mantissa = (bucket - HISTOGRAM_EXACT_BUCKETS) % HISTOGRAM_BUCKETS_PER_POWER;
+    long long lowest = (long long)(HISTOGRAM_BUCKETS_PER_POWER + mantissa) << (exponent - 3);
+    long long limit = lowest + (1LL << (exponent - 3)) - 1;
+    return limit > INT_MAX ? INT_MAX : (int)limit;
+}
+
+static void addBurstTime(burstStatistics *bursts, int burstTime)
+{
+    // O(log buckets) for the histogram, O(1) for the mean and variance
+    for (int i = getHistogramBucket(burstTime) + 1; i <= SCHEDULER_HISTOGRAM_BUCKETS; i += i & -i)
+    {
+        bursts->tree[i]++;
+    }
+    bursts->count++;
+    double delta = burstTime - bursts->mean;
+    bursts->mean += delta / bursts->count;
+    bursts->m2 += delta * (burstTime - bursts->mean);
+}
+
+static int getBurstPercentile(const burstStatistics *bursts, float percentile)
+{
+    // Upper limit of the bucket holding the percentile, so at least that share of the burst times fits into it
+    // Descends the Fenwick tree to the first bucket whose running count reaches the rank
+    int rank = (int)ceil(percentile / 100.0 * bursts->count);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    int position = 0;
+    for (int step = SCHEDULER_HISTOGRAM_BUCKETS; step > 0; step /= 2)
+    {
+        if (position + step <= SCHEDULER_HISTOGRAM_BUCKETS && bursts->tree[position + step] < rank)
+        {
+            position += step;
+            rank -= bursts->tree[position];
+        }
+    }
+    return getHistogramBucketLimit(position); // bucket position, 0-based
+}
+
+static int getAdaptiveTimeQuantum(scheduler *s)
+{
+    // Time quantum derived from the burst times admitted so far, at least 1
+    // A percentile near 80 follows the rule of thumb that most bursts should complete within one time quantum
+    const burstStatistics *bursts = &s->bursts;
+    double timeQuantum;
+    switch (s->options.quantumMode)
+    {
+    case SCHEDULER_QUANTUM_MEDIAN:
+        timeQuantum = getBurstPercentile(bursts, 50.0f);
+        break;
+    case SCHEDULER_QUANTUM_PERCENTILE:
+        timeQuantum = getBurstPercentile(bursts, s->options.quantumPercentile);
+        break;
+    case SCHEDULER_QUANTUM_MEAN_STDDEV:
+        timeQuantum = bursts->mean + s->options.quantumStddevs * sqrt(bursts->m2 / bursts->count);
+        break;
+    default:
+        timeQuantum = s->options.timeQuantum;
+        break;
+    }
+    if (timeQuantum < 1.0)
+    {
+        return 1;
+    }
+    return timeQuantum > MAX_ADAPTIVE_TIME_QUANTUM ? MAX_ADAPTIVE_TIME_QUANTUM : (int)timeQuantum;
+}
+
+static cpuState *getLeastLoadedCpu(scheduler *s)
+{
+    // CPU with the fewest uncompleted processes in its ready queue, lowest index on ties
+    // Dense argmin over the load column, which keeps the first of equal loads
+    if (s->options.cpuCount == 1)
+    {
+        return &s->cpus[0];
+    }
+    columnReduction load;
+    ReduceColumn(s->cpuLoad, s->options.cpuCount, &load);
+    return &s->cpus[load.argmin];
+}
+
+static void initReadyQueue(readyQueueList *readyQueue)
+{
+    readyQueue->head = NULL;
+    readyQueue->tail = NULL;
+    readyQueue->freeNodes = NULL;
+    readyQueue->slabs = NULL;
+    readyQueue->slabNodesUsed = READY_QUEUE_SLAB_SIZE; // forces a slab to be allocated for the first node
+    readyQueue->processesAdded = 0;
+    readyQueue->runningNode = NULL;
+    readyQueue->readyCount = 0;
+    readyQueue->runningCount = 0;
+    readyQueue->completedCount = 0;
+}
+
+static readyQueueNode *allocateReadyQueueNode(readyQueueList *readyQueue)
+{
+    // Reuses a node of a completed process when available, else carves the next node out of the newest slab
+    // NULL if out of memory
+    readyQueueNode *node = readyQueue->freeNodes;
+    if (node != NULL)
+    {
+        readyQueue->freeNodes = node->next;
+        return node;
+    }
+
+    if (readyQueue->slabNodesUsed == READY_QUEUE_SLAB_SIZE)
+    {
+        readyQueueSlab *slab = malloc(sizeof(readyQueueSlab));
+        if (slab == NULL) {
+            return NULL;
+        }
+        slab->next = readyQueue->slabs;
+        readyQueue->slabs = slab;
+        readyQueue->slabNodesUsed = 0;
+    }
+    node = &readyQueue->slabs->nodes[readyQueue->slabNodesUsed];
+    readyQueue->slabNodesUsed++;
+    return node;
+}
+
+static bool AddToReadyQueue(int fileID, readyQueueList *readyQueue, readyQueueHeap *heap)
+{
+    // Adds process to back of ready queue once the arrival time is lower or equals to time elapsed
+    readyQueueNode *newNode = allocateReadyQueueNode(readyQueue);
+    if (newNode == NULL)
+    {
+        return false;
+    }
+    newNode->fileID = fileID;
+    newNode->waiting = false;
+    if (!heapPush(heap, newNode))
+    {
+        newNode->next = readyQueue->freeNodes;
+        readyQueue->freeNodes = newNode;
+        return false;
+    }
+    LinkToReadyQueue(newNode, readyQueue);
+
+    readyQueue->processesAdded++;
+    readyQueue->readyCount++;
+    return true;
+}
+
+static void LinkToReadyQueue(readyQueueNode *node, readyQueueList *readyQueue)
+{
+    // Appends node to the back of the linked list, counts are left to the caller
+    node->next = NULL;
+    node->prev = readyQueue->tail;
+
+    // If queue empty, file entry becomes head of list
+    if (readyQueue->tail == NULL)
+    {
+        readyQueue->head = node;
+    }
+    else
+    {
+        readyQueue->tail->next = node;
+    }
+    readyQueue->tail = node;
+}
+
+static void UnlinkFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue)
+{
+    // Takes node out of the linked list, counts are left to the caller
+    if (node->prev == NULL)
+    {
+        readyQueue->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+    if (node->next == NULL)
+    {
+        readyQueue->tail = node->prev;
+    }
+    else
+    {
+        node->next->prev = node->prev;
+    }
+}
+
+static void RemoveFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue)
+{
+    // Unlinks node of completed process and keeps it for reuse by the next process added
+    // Nodes that migrated between CPUs are kept by the CPU they completed on until reclaimFreeNodes hands them back
+    // out, slabs are only freed on destroy
+    UnlinkFromReadyQueue(node, readyQueue);
+    if (readyQueue->runningNode == node)
+    {
+        readyQueue->runningNode = NULL;
+        readyQueue->runningCount--;
+    }
+    else
+    {
+        readyQueue->readyCount--;
+    }
+    readyQueue->completedCount++;
+
+    node->next = readyQueue->freeNodes;
+    readyQueue->freeNodes = node;
+}
+
+static void DispatchFromReadyQueue(readyQueueNode *node, readyQueueList *readyQueue, jobTable *jobs, int timeElapsed)
+{
+    // Gives node the CPU, a different process still holding it is preempted back to the ready state
+    // Waiting time is settled lazily here: time since the process entered ready state is added once per dispatch
+    if (readyQueue->runningNode == node)
+    {
+        // still holding the CPU from its last time slice, it has not waited since
+        return;
+    }
+    if (readyQueue->runningNode != NULL)
+    {
+        // back in the ready state since its time slice ended (finishTimeSlice)
+        readyQueue->readyCount++;
+        readyQueue->runningCount--;
+    }
+
+    int fid = node->fileID;
+    jobs->waitingTime[fid] += timeElapsed - jobs->readySince[fid];
+    if (jobs->responseTime[fid] == -1)
+    {
+        jobs->responseTime[fid] = timeElapsed - jobs->arrivalTime[fid];
+    }
+    readyQueue->runningNode = node;
+    readyQueue->runningCount++;
+    readyQueue->readyCount--;
+}
+
+// Live counts of the ready queue, O(1)
+static int GetReadyProcessCount(const readyQueueList *readyQueue)
+{
+    return readyQueue->readyCount;
+}
+
+static int GetRunningProcessCount(const readyQueueList *readyQueue)
+{
+    return readyQueue->runningCount;
+}
+
+static int GetCompletedProcessCount(const readyQueueList *readyQueue)
+{
+    return readyQueue->completedCount;
+}
+
+static int CountUncompletedProcessesInQueue(const readyQueueList *readyQueue)
+{
+    // returns uncompleted processes in queue i.e., hasCompleted flag not set (remaining burst time > 0)
+    // read from the live counters instead of walking the queue
+    return GetReadyProcessCount(readyQueue) + GetRunningProcessCount(readyQueue);
+}
+
+static readyQueueNode *getNextProcess(readyQueueHeap *heap)
+{
+    // Obtain node of the ready process the policy dispatches next, e.g., lowest remaining burst time
+    // if multiple process with same remaining burst times return process with lowest arrival time (FIFO),
+    // processes that arrived together are ordered by fid i.e., the order they were added to the queue
+    // Heap keeps the lowest at its root, so this is O(1)
+    if (heap->size == 0)
+    {
+        return NULL;
+    }
+    return heap->nodes[0];
+}
+
+static bool heapNodeIsLower(readyQueueHeap *heap, readyQueueNode *a, readyQueueNode *b)
+{
+    // Heap ordering is the policy's order of dispatch
+    PROFILE_VISIT(1);
+    return heap->policy->isLower(heap->jobs, a->fileID, b->fileID);
+}
+
+static void heapSwap(readyQueueHeap *heap, int i, int j)
+{
+    readyQueueNode *tmp = heap->nodes[i];
+    heap->nodes[i] = heap->nodes[j];
+    heap->nodes[j] = tmp;
+    heap->nodes[i]->heapIndex = i;
+    heap->nodes[j]->heapIndex = j;
+}
+
+static void heapSiftUp(readyQueueHeap *heap, int i)
+{
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!heapNodeIsLower(heap, heap->nodes[i], heap->nodes[parent]))
+        {
+            break;
+        }
+        heapSwap(heap, i, parent);
+        i = parent;
+    }
+}
+
+static void heapSiftDown(readyQueueHeap *heap, int i)
+{
+    while (true)
+    {
+        int lowest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < heap->size && heapNodeIsLower(heap, heap->nodes[left], heap->nodes[lowest]))
+        {
+            lowest = left;
+        }
+        if (right < heap->size && heapNodeIsLower(heap, heap->nodes[right], heap->nodes[lowest]))
+        {
+            lowest = right;
+        }
+        if (lowest == i)
+        {
+            break;
+        }
+        heapSwap(heap, i, lowest);
+        i = lowest;
+    }
+}
+
+static bool heapPush(readyQueueHeap *heap, readyQueueNode *node)
+{
+    // Adds node as a leaf and moves it up to its position, false if the heap could not grow
+    if (heap->size == heap->capacity)
+    {
+        int capacity = heap->capacity > 0 ? heap->capacity * 2 : JOB_TABLE_INITIAL_CAPACITY;
+        readyQueueNode **nodes = reallocateColumn(heap->nodes, heap->capacity, capacity, sizeof(readyQueueNode *));
+        if (nodes == NULL)
+        {
+            return false;
+        }
+        heap->nodes = nodes;
+        heap->capacity = capacity;
+    }
+    node->heapIndex = heap->size;
+    heap->nodes[heap->size] = node;
+    heap->size++;
+    heapSiftUp(heap, node->heapIndex);
+    return true;
+}
+
+static void heapRemove(readyQueueHeap *heap, readyQueueNode *node)
+{
+    // Removes node from anywhere in the heap by replacing it with the last leaf
+    int i = node->heapIndex;
+    heap->size--;
+    if (i != heap->size)
+    {
+        heap->nodes[i] = heap->nodes[heap->size];
+        heap->nodes[i]->heapIndex = i;
+        heapSiftUp(heap, i);
+        heapSiftDown(heap, heap->nodes[i]->heapIndex);
+    }
+    node->heapIndex = -1;
+}
+
+static void heapUpdateKey(readyQueueHeap *heap, readyQueueNode *node)
+{
+    // Restores heap order after the remaining burst time of node changed in place
+    heapSiftUp(heap, node->heapIndex);
+    heapSiftDown(heap, node->heapIndex);
+}
+
+static void freeAllocatedMemory(readyQueueList *readyQueue) {
+    // Frees memory allocated for linked list (ReadyQueue), nodes are released a slab at a time
+    readyQueueSlab *tmp = NULL;
+    while (readyQueue->slabs != NULL) {
+        tmp = readyQueue->slabs;
+        readyQueue->slabs = readyQueue->slabs->next;
+        free(tmp);
+    }
+    initReadyQueue(readyQueue);
+}
+
+#ifdef SCHEDULER_PROFILE
+static long long getProfileClock(void)
+{
+    // Monotonic nanoseconds
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static profileSpan beginProfileSpan(void)
+{
+    profileSpan span;
+    span.visits = profile.visits;
+    span.start = getProfileClock();
+    return span;
+}
+
+static void endProfileSpan(const profileSpan *span, schedulerPhase phase)
+{
+    // Charges the phase with the time and nodes visited since beginProfileSpan, nested phases included
+    long long end = getProfileClock();
+    schedulerPhaseStats *stats = &profile.phases[phase];
+    long long visited = profile.visits - span->visits;
+    stats->calls++;
+    stats->nodesVisited += visited;
+    stats->nanoseconds += end - span->start;
+    if (!profile.recordEvents)
+    {
+        return;
+    }
+    if (profile.events == NULL)
+    {
+        profile.events = malloc(PROFILE_MAX_EVENTS * sizeof(schedulerPhaseEvent));
+    }
+    if (profile.events == NULL || profile.eventCount == PROFILE_MAX_EVENTS)
+    {
+        profile.droppedEvents++;
+        return;
+    }
+    schedulerPhaseEvent *event = &profile.events[profile.eventCount];
+    event->phase = phase;
+    event->startTime = span->start - profile.origin;
+    event->duration = end - span->start;
+    event->nodesVisited = visited;
+    profile.eventCount++;
+}
+#endif
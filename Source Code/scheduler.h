@@ -0,0 +1,272 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/*
+Hybrid round robin (RR) + shortest job first (SJF) scheduler as a reentrant library.
+Every simulation lives in its own opaque scheduler context, there is no global state and
+errors are returned as a schedulerStatus instead of ending the process.
+
+Typical use:
+>> scheduler *s = SchedulerCreate(&options);
+>> SchedulerAddJob(s, arrivalTime, burstTime); ... for every process
+>> SchedulerRun(s);
+>> SchedulerGetResults(s, &results);
+>> SchedulerDestroy(s);
+
+Processes may also be added while stepping (online use), SchedulerNeedsArrival tells when the
+scheduler must learn the next arrival before SchedulerStep can decide. Once stepping has started,
+arrival times must not decrease. SchedulerAddNumberedJob keeps the process number of a trace that is fed
+in arrival order rather than trace order, so it is scheduled exactly as if the whole trace had been added.
+
+With schedulerOptions.cpuCount > 1 several CPUs are simulated, each with its own ready queue under the
+same dynamic time quantum rule. Arriving processes join the least loaded CPU and a CPU whose ready queue
+runs empty steals a ready process from the busiest one. A single CPU behaves exactly as before.
+
+Processes may carry a priority class (0 is the highest) and a group, e.g., a tenant, through
+SchedulerAddClassifiedJob. Every policy reports wait and turnaround per class, SCHEDULER_POLICY_FAIR_SHARE
+also schedules by them: CPU time is shared between groups by weight, within a group the highest
+priority class runs first under the hybrid RR + SJF rule, and aging lifts processes that have waited long.
+
+SchedulerSaveSnapshot writes the whole state of a simulation between two steps to a binary file, and
+SchedulerLoadSnapshot continues it in a new context. Processes may then be added (arriving no earlier than the
+snapshot) or changed with SchedulerSetBurstTime before stepping on, so a what-if question about the suffix of a
+long trace only costs the suffix. Snapshots are in native byte order and read back by the same build.
+
+Built with -DSCHEDULER_PROFILE, the engine counts calls, nodes visited and nanoseconds per phase of a step
+(admission, enqueue, selection, waiting time settling, dispatch and end of a time slice) in counters of the
+calling thread, the only state kept outside a context, which SchedulerGetProfile reads. Without it the instrumentation compiles to nothing and the
+counters stay 0, so it can be left in place in a release build.
+*/
+
+#define DEFAULT_TIME_QUANTUM 5    // arbritary default value
+#define DEFAULT_AGING_INTERVAL 50 // time waited per priority level gained, SCHEDULER_POLICY_FAIR_SHARE
+#define SCHEDULER_PRIORITY_LEVELS 4 // priority classes 0 (highest) to SCHEDULER_PRIORITY_LEVELS - 1
+
+typedef struct scheduler scheduler;
+
+typedef enum schedulerStatus
+{
+    SCHEDULER_OK = 0,
+    SCHEDULER_FINISHED,              // SchedulerStep: input closed and every process completed
+    SCHEDULER_OUT_OF_MEMORY,
+    SCHEDULER_INVALID_ARGUMENT,      // negative arrival / burst time, bad option or index
+    SCHEDULER_ARRIVAL_OUT_OF_ORDER,  // process added after stepping started arrives before an earlier one
+    SCHEDULER_INPUT_CLOSED,          // process added after SchedulerCloseInput
+    SCHEDULER_IO_ERROR               // snapshot could not be written, or the file read is not a snapshot of this build
+} schedulerStatus;
+
+typedef enum schedulerPolicy
+{
+    // Built-in scheduling policies, all share the event driven engine and differ in dispatch order and time slice
+    SCHEDULER_POLICY_HYBRID = 0, // RR with dynamic time quantum + SJF, the default
+    SCHEDULER_POLICY_FCFS,       // first come first served, runs each process to completion
+    SCHEDULER_POLICY_RR,         // round robin with a fixed time quantum
+    SCHEDULER_POLICY_SJF,        // non-preemptive shortest job first
+    SCHEDULER_POLICY_SRTF,       // preemptive shortest remaining time first, decided at every arrival
+    SCHEDULER_POLICY_MLFQ,       // multilevel feedback queue, time quantum doubles per level
+    SCHEDULER_POLICY_FAIR_SHARE, // weighted fair share between groups, hybrid RR + SJF per priority class with aging
+    SCHEDULER_POLICY_COUNT
+} schedulerPolicy;
+
+typedef enum schedulerQuantumMode
+{
+    // How the time quantum is chosen, adaptive modes derive it from the burst times of the processes admitted so far
+    SCHEDULER_QUANTUM_FIXED = 0,   // schedulerOptions.timeQuantum throughout
+    SCHEDULER_QUANTUM_MEDIAN,      // median burst time
+    SCHEDULER_QUANTUM_PERCENTILE,  // schedulerOptions.quantumPercentile of the burst times
+    SCHEDULER_QUANTUM_MEAN_STDDEV, // mean + schedulerOptions.quantumStddevs standard deviations of the burst times
+    SCHEDULER_QUANTUM_MODE_COUNT
+} schedulerQuantumMode;
+
+typedef struct schedulerCompletion
+{
+    // Record of one completed process
+    int process;        // position of the process in order of adding, printed as Process-(process + 1)
+    int arrivalTime;
+    int burstTime;
+    int completionTime;
+    int waitingTime;
+    int turnAroundTime;
+    int responseTime;
+    int dispatches;     // times a CPU switched to the process
+    int priority;
+    int group;
+} schedulerCompletion;
+
+typedef struct schedulerTimeSlice
+{
+    // One time slice a CPU spent running a process, [startTime, endTime), the switch before it excluded
+    int cpu;
+    int process;        // position of the process in order of adding, as in schedulerCompletion
+    int startTime;
+    int endTime;
+} schedulerTimeSlice;
+
+typedef void (*schedulerCompletionCallback)(void *context, const schedulerCompletion *completion);
+typedef void (*schedulerTimeSliceCallback)(void *context, const schedulerTimeSlice *slice);
+
+typedef struct schedulerOptions
+{
+    int timeQuantum;          // DEFAULT_TIME_QUANTUM unless tuned
+    int cpuCount;             // CPUs simulated, each with its own ready queue, 1 unless tuned
+    schedulerPolicy policy;   // SCHEDULER_POLICY_HYBRID unless tuned
+    schedulerQuantumMode quantumMode; // SCHEDULER_QUANTUM_FIXED unless tuned
+    float quantumPercentile;  // 80 unless tuned, for SCHEDULER_QUANTUM_PERCENTILE, in (0, 100]
+    float quantumStddevs;     // 1 unless tuned, for SCHEDULER_QUANTUM_MEAN_STDDEV, >= 0
+    int switchCost;           // time a CPU spends switching to a different process, counted as waiting, 0 unless tuned
+    bool retainCompletions;   // keep every completion for SchedulerGetCompletion, memory then grows with the trace
+    int groupCount;           // groups numbered from 0 that processes may belong to, 1 unless tuned
+    const int *groupWeights;  // groupCount shares of CPU time (>= 1) for SCHEDULER_POLICY_FAIR_SHARE, NULL for equal shares, copied
+    int agingInterval;        // SCHEDULER_POLICY_FAIR_SHARE: a ready process gains a priority level per interval waited, 0 disables aging
+    schedulerCompletionCallback onCompletion; // called as each process completes, may be NULL
+    schedulerTimeSliceCallback onTimeSlice;   // called as each time slice ends, before its completion if any, may be NULL
+    void *callbackContext;
+} schedulerOptions;
+
+typedef struct schedulerResults
+{
+    // Metrics over the processes completed so far, accumulated in order of completion
+    int completed;
+    float averageTurnaroundTime;
+    float maxTurnaroundTime;
+    float averageWaitingTime;
+    float maxWaitingTime;
+    float minWaitingTime;
+    float minTurnaroundTime;
+    float averageResponseTime;
+    int timeQuantum;           // time quantum in use, changes over the simulation with an adaptive quantumMode
+    long long contextSwitches; // CPUs given to a different process than the one that last held them
+    long long preemptions;     // context switches away from a process that had not completed
+    long long switchTime;      // time spent switching over every CPU, contextSwitches * switchCost
+    float averageDispatches;   // context switches to a process, per completed process
+    int maxDispatches;
+    long long events;          // simulated events processed, arrivals admitted and time slices ended
+} schedulerResults;
+
+#define SCHEDULER_HISTOGRAM_BUCKETS 256 // log-linear buckets, enough for any non-negative int
+
+typedef enum schedulerMetric
+{
+    SCHEDULER_METRIC_WAITING_TIME = 0,
+    SCHEDULER_METRIC_TURNAROUND_TIME,
+    SCHEDULER_METRIC_RESPONSE_TIME,
+    SCHEDULER_METRIC_COUNT
+} schedulerMetric;
+
+typedef struct schedulerHistogram
+{
+    // Histogram of times streamed in one at a time, for percentiles such as p99
+    // Buckets are exact below 16, then 8 per power of two so percentiles are within 1/8 of the exact value
+    // Fixed size, memory does not depend on the number of processes, histograms of several runs can be merged
+    long long counts[SCHEDULER_HISTOGRAM_BUCKETS];
+    long long count;
+    int min;
+    int max;
+} schedulerHistogram;
+
+typedef struct schedulerCpuStats
+{
+    // Activity of one CPU over the time slices ended so far
+    long long busyTime;   // time spent running processes
+    long long switchTime; // time spent switching between processes, not part of busyTime
+    float utilization;    // busy time over time elapsed
+    int migrations;       // processes stolen from the ready queues of other CPUs
+    int completed;        // processes completed on this CPU
+} schedulerCpuStats;
+
+typedef struct schedulerClassStats
+{
+    // Processes of one priority class or one group
+    int completed;
+    float averageWaitingTime;
+    float averageTurnaroundTime;
+    int maxWaitingTime;
+    int maxTurnaroundTime;
+    long long serviceTime; // CPU time received, uncompleted processes included
+} schedulerClassStats;
+
+typedef enum schedulerPhase
+{
+    // Instrumented parts of a step, times include the phases nested in them
+    SCHEDULER_PHASE_ADMIT = 0, // arrivals admitted into the ready queues, includes SCHEDULER_PHASE_ENQUEUE
+    SCHEDULER_PHASE_ENQUEUE,   // one process added to a ready queue
+    SCHEDULER_PHASE_SELECT,    // process dispatched next picked from a ready queue
+    SCHEDULER_PHASE_SETTLE,    // waiting time of the dispatched process settled
+    SCHEDULER_PHASE_DISPATCH,  // an idle CPU given a time slice, includes selection and settling
+    SCHEDULER_PHASE_FINISH,    // a time slice accounted for as it ends
+    SCHEDULER_PHASE_COUNT
+} schedulerPhase;
+
+typedef struct schedulerPhaseStats
+{
+    long long calls;
+    long long nodesVisited; // heap nodes compared, arrivals and priority classes looked at
+    long long nanoseconds;
+} schedulerPhaseStats;
+
+typedef struct schedulerPhaseEvent
+{
+    // One call of a phase, for a trace of the engine
+    schedulerPhase phase;
+    long long startTime;    // nanoseconds since SchedulerResetProfile
+    long long duration;     // nanoseconds
+    long long nodesVisited;
+} schedulerPhaseEvent;
+
+typedef struct schedulerProfile
+{
+    // Counters of the calling thread since SchedulerResetProfile, over every context it stepped
+    bool enabled;                 // built with SCHEDULER_PROFILE, everything else is 0 otherwise
+    schedulerPhaseStats phases[SCHEDULER_PHASE_COUNT];
+    long long events;             // phase events kept for SchedulerGetPhaseEvent
+    long long droppedEvents;      // phase events past the limit, counted but not kept
+} schedulerProfile;
+
+void SchedulerDefaultOptions(schedulerOptions *options);
+scheduler *SchedulerCreate(const schedulerOptions *options);
+void SchedulerDestroy(scheduler *s);
+
+schedulerStatus SchedulerAddJob(scheduler *s, int arrivalTime, int burstTime);
+schedulerStatus SchedulerAddJobColumns(scheduler *s, const int *arrivalTime, const int *burstTime, int count);
+schedulerStatus SchedulerAddClassifiedJob(scheduler *s, int arrivalTime, int burstTime, int priority, int group);
+schedulerStatus SchedulerAddNumberedJob(scheduler *s, int process, int arrivalTime, int burstTime, int priority, int group);
+schedulerStatus SchedulerAddJobClassColumns(scheduler *s, const int *arrivalTime, const int *burstTime,
+                                            const int *priority, const int *group, int count);
+schedulerStatus SchedulerSetBurstTime(scheduler *s, int process, int burstTime);
+void SchedulerCloseInput(scheduler *s);
+bool SchedulerNeedsArrival(scheduler *s);
+
+schedulerStatus SchedulerStep(scheduler *s);
+schedulerStatus SchedulerRun(scheduler *s);
+
+int SchedulerGetTime(const scheduler *s);
+int SchedulerGetReadyCount(const scheduler *s);
+int SchedulerGetRunningCount(const scheduler *s);
+int SchedulerGetCompletedCount(const scheduler *s);
+int SchedulerGetCpuCount(const scheduler *s);
+schedulerStatus SchedulerGetCpuStats(const scheduler *s, int cpu, schedulerCpuStats *stats);
+void SchedulerGetResults(const scheduler *s, schedulerResults *results);
+schedulerStatus SchedulerGetCompletion(const scheduler *s, int i, schedulerCompletion *completion);
+schedulerStatus SchedulerGetHistogram(const scheduler *s, schedulerMetric metric, schedulerHistogram *histogram);
+schedulerStatus SchedulerGetPriorityStats(const scheduler *s, int priority, schedulerClassStats *stats);
+schedulerStatus SchedulerGetGroupStats(const scheduler *s, int group, schedulerClassStats *stats);
+schedulerStatus SchedulerSaveSnapshot(const scheduler *s, FILE *fp);
+schedulerStatus SchedulerLoadSnapshot(FILE *fp, const schedulerOptions *callbacks, scheduler **restored);
+void SchedulerDump(scheduler *s);
+const char *SchedulerPolicyName(schedulerPolicy policy);
+const char *SchedulerPhaseName(schedulerPhase phase);
+const char *SchedulerStatusString(schedulerStatus status);
+
+void SchedulerHistogramInit(schedulerHistogram *histogram);
+void SchedulerHistogramAdd(schedulerHistogram *histogram, int value);
+void SchedulerHistogramMerge(schedulerHistogram *into, const schedulerHistogram *from);
+int SchedulerHistogramPercentile(const schedulerHistogram *histogram, double percentile);
+
+void SchedulerResetProfile(bool recordEvents);
+void SchedulerGetProfile(schedulerProfile *profile);
+schedulerStatus SchedulerGetPhaseEvent(long long i, schedulerPhaseEvent *event);
+
+#endif
@@ -0,0 +1,348 @@
+#define _POSIX_C_SOURCE 200809L // sysconf
+#include <stdlib.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "sweep.h"
+
+typedef struct sweepDeque
+{
+    // Simulations assigned to one worker, the owner takes from bottom, thieves take from top
+    int *tasks;
+    int top;
+    int bottom;
+    pthread_mutex_t lock;
+} sweepDeque;
+
+typedef struct sweepPool
+{
+    const sweepTrace *traces;
+    int **orders;         // per trace, its rows in arrival order, NULL for a trace already in arrival order
+    const sweepConfig *configs;
+    int configCount;
+    sweepResult *results; // one per task, task == trace * configCount + config index
+    sweepDeque *deques;
+    int threadCount;
+} sweepPool;
+
+typedef struct sweepWorker
+{
+    sweepPool *pool;
+    int id;
+} sweepWorker;
+
+static bool indexTrace(const sweepTrace *trace, int **order);
+static bool popTask(sweepDeque *deque, int *task);
+static bool stealTask(sweepDeque *deque, int *task);
+static void runSweepTask(sweepPool *pool, int task);
+static void *sweepWorkerMain(void *argument);
+
+int SweepDefaultThreadCount(void)
+{
+    // One worker per online core
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+void SweepDefaultConfig(sweepConfig *config)
+{
+    // The settings of a scheduler with default options
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    config->policy = options.policy;
+    config->timeQuantum = options.timeQuantum;
+    config->switchCost = options.switchCost;
+    config->cpuCount = options.cpuCount;
+}
+
+schedulerStatus RunSweep(const sweepTrace *traces, int traceCount, const int *timeQuanta, int quantumCount, int threadCount, sweepResult *results)
+{
+    // Sweeps the time quantum alone, every other setting as in SweepDefaultConfig
+    if (quantumCount < 0)
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    sweepConfig *configs = calloc(quantumCount > 0 ? quantumCount : 1, sizeof(sweepConfig));
+    if (configs == NULL)
+    {
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+    for (int i = 0; i < quantumCount; i++)
+    {
+        SweepDefaultConfig(&configs[i]);
+        configs[i].timeQuantum = timeQuanta[i];
+    }
+    schedulerStatus status = RunSweepConfigs(traces, traceCount, configs, quantumCount, threadCount, results);
+    free(configs);
+    return status;
+}
+
+schedulerStatus RunSweepConfigs(const sweepTrace *traces, int traceCount, const sweepConfig *configs, int configCount, int threadCount, sweepResult *results)
+{
+    // Fills results with traceCount * configCount entries, ordered by trace then configuration
+    // A simulation that fails leaves its status in its result, the sweep itself only fails if it cannot start
+    if (traceCount < 0 || configCount < 0 || threadCount < 1 || (configCount > 0 && traceCount > INT_MAX / configCount))
+    {
+        return SCHEDULER_INVALID_ARGUMENT;
+    }
+    int taskCount = traceCount * configCount;
+    if (threadCount > taskCount)
+    {
+        threadCount = taskCount > 0 ? taskCount : 1;
+    }
+
+    sweepPool pool;
+    pool.traces = traces;
+    pool.configs = configs;
+    pool.configCount = configCount;
+    pool.results = results;
+    pool.threadCount = threadCount;
+    pool.orders = calloc(traceCount > 0 ? traceCount : 1, sizeof(int *));
+    pool.deques = calloc(threadCount, sizeof(sweepDeque));
+    sweepWorker *workers = calloc(threadCount, sizeof(sweepWorker));
+    pthread_t *threads = calloc(threadCount, sizeof(pthread_t));
+    int *tasks = calloc(taskCount > 0 ? taskCount : 1, sizeof(int));
+    bool indexed = pool.orders != NULL;
+    for (int t = 0; t < traceCount && indexed && configCount > 0; t++)
+    {
+        indexed = indexTrace(&traces[t], &pool.orders[t]);
+    }
+    if (!indexed || pool.deques == NULL || workers == NULL || threads == NULL || tasks == NULL)
+    {
+        for (int t = 0; pool.orders != NULL && t < traceCount; t++)
+        {
+            free(pool.orders[t]);
+        }
+        free(pool.orders);
+        free(pool.deques);
+        free(workers);
+        free(threads);
+        free(tasks);
+        return SCHEDULER_OUT_OF_MEMORY;
+    }
+
+    // Deal the tasks out round robin, so every worker starts with a mix of traces
+    int next = 0;
+    for (int w = 0; w < threadCount; w++)
+    {
+        sweepDeque *deque = &pool.deques[w];
+        deque->tasks = tasks + next;
+        deque->top = 0;
+        deque->bottom = 0;
+        for (int task = w; task < taskCount; task += threadCount)
+        {
+            deque->tasks[deque->bottom] = task;
+            deque->bottom++;
+        }
+        next += deque->bottom;
+        pthread_mutex_init(&deque->lock, NULL);
+    }
+
+    // The calling thread is worker 0
+    int started = 1;
+    for (int w = 0; w < threadCount; w++)
+    {
+        workers[w].pool = &pool;
+        workers[w].id = w;
+    }
+    for (int w = 1; w < threadCount; w++)
+    {
+        if (pthread_create(&threads[w], NULL, sweepWorkerMain, &workers[w]) != 0)
+        {
+            break; // remaining deques are drained by stealing
+        }
+        started++;
+    }
+    sweepWorkerMain(&workers[0]);
+    for (int w = 1; w < started; w++)
+    {
+        pthread_join(threads[w], NULL);
+    }
+
+    for (int w = 0; w < threadCount; w++)
+    {
+        pthread_mutex_destroy(&pool.deques[w].lock);
+    }
+    for (int t = 0; t < traceCount; t++)
+    {
+        free(pool.orders[t]);
+    }
+    free(pool.orders);
+    free(pool.deques);
+    free(workers);
+    free(threads);
+    free(tasks);
+    return SCHEDULER_OK;
+}
+
+static bool indexTrace(const sweepTrace *trace, int **order)
+{
+    // Rows of the trace in arrival order, built once and shared by every simulation of the trace
+    // Left NULL for a trace already in arrival order, the usual case; false if out of memory
+    *order = NULL;
+    int count = trace->count;
+    int i = 1;
+    while (i < count && trace->arrivalTime[i - 1] <= trace->arrivalTime[i])
+    {
+        i++;
+    }
+    if (i >= count)
+    {
+        return true;
+    }
+    int *rows = malloc((size_t)count * sizeof(int));
+    int *merged = malloc((size_t)count * sizeof(int));
+    if (rows == NULL || merged == NULL)
+    {
+        free(rows);
+        free(merged);
+        return false;
+    }
+    for (int row = 0; row < count; row++)
+    {
+        rows[row] = row;
+    }
+
+    // Bottom-up merge sort, stable so equal arrival times keep trace order as they do in the scheduler
+    for (long long width = 1; width < count; width *= 2)
+    {
+        for (long long start = 0; start < count; start += 2 * width)
+        {
+            int left = (int)start;
+            int middle = (int)(start + width < count ? start + width : count);
+            int right = middle;
+            int end = (int)(start + 2 * width < count ? start + 2 * width : count);
+            for (int k = (int)start; k < end; k++)
+            {
+                if (right == end || (left < middle && trace->arrivalTime[rows[left]] <= trace->arrivalTime[rows[right]]))
+                {
+                    merged[k] = rows[left];
+                    left++;
+                }
+                else
+                {
+                    merged[k] = rows[right];
+                    right++;
+                }
+            }
+        }
+        int *swap = rows;
+        rows = merged;
+        merged = swap;
+    }
+    free(merged);
+    *order = rows;
+    return true;
+}
+
+static bool popTask(sweepDeque *deque, int *task)
+{
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top)
+    {
+        deque->bottom--;
+        *task = deque->tasks[deque->bottom];
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static bool stealTask(sweepDeque *deque, int *task)
+{
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom > deque->top)
+    {
+        *task = deque->tasks[deque->top];
+        deque->top++;
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+static void runSweepTask(sweepPool *pool, int task)
+{
+    // One simulation, fed from the shared trace in arrival order whenever the scheduler needs the next arrival
+    // Only the processes in flight are copied into the scheduler, completed ones free their row for the next
+    // Each process keeps its trace row as its number, so the simulation matches adding the whole trace
+    int traceIndex = task / pool->configCount;
+    const sweepTrace *trace = &pool->traces[traceIndex];
+    const sweepConfig *config = &pool->configs[task % pool->configCount];
+    const int *order = pool->orders[traceIndex];
+    sweepResult *result = &pool->results[task];
+    result->trace = traceIndex;
+    result->config = task % pool->configCount;
+    result->timeQuantum = config->timeQuantum;
+
+    schedulerOptions options;
+    SchedulerDefaultOptions(&options);
+    options.policy = config->policy;
+    options.timeQuantum = config->timeQuantum;
+    options.switchCost = config->switchCost;
+    options.cpuCount = config->cpuCount;
+    options.groupCount = trace->groupCount > 1 ? trace->groupCount : 1;
+    scheduler *s = SchedulerCreate(&options);
+    if (s == NULL)
+    {
+        bool valid = config->policy >= 0 && config->policy < SCHEDULER_POLICY_COUNT && config->timeQuantum >= 1 &&
+                     config->switchCost >= 0 && config->cpuCount >= 1;
+        result->status = valid ? SCHEDULER_OUT_OF_MEMORY : SCHEDULER_INVALID_ARGUMENT;
+        return;
+    }
+    int next = 0;
+    schedulerStatus status = SCHEDULER_OK;
+    while (status == SCHEDULER_OK)
+    {
+        while (status == SCHEDULER_OK && next < trace->count && SchedulerNeedsArrival(s))
+        {
+            int row = order != NULL ? order[next] : next;
+            status = SchedulerAddNumberedJob(s, row, trace->arrivalTime[row], trace->burstTime[row],
+                                             trace->priority != NULL ? trace->priority[row] : 0,
+                                             trace->group != NULL ? trace->group[row] : 0);
+            next++;
+        }
+        if (next == trace->count)
+        {
+            SchedulerCloseInput(s);
+        }
+        if (status == SCHEDULER_OK)
+        {
+            status = SchedulerStep(s);
+        }
+    }
+    result->status = status == SCHEDULER_FINISHED ? SCHEDULER_OK : status;
+    SchedulerGetResults(s, &result->results);
+    SchedulerDestroy(s);
+}
+
+static void *sweepWorkerMain(void *argument)
+{
+    // Runs its own tasks, then steals from the other workers until every deque is empty
+    // No task creates new ones, so a full pass without finding work means the sweep is done
+    sweepWorker *worker = argument;
+    sweepPool *pool = worker->pool;
+    int task;
+    while (true)
+    {
+        if (popTask(&pool->deques[worker->id], &task))
+        {
+            runSweepTask(pool, task);
+            continue;
+        }
+        bool stolen = false;
+        for (int i = 1; i < pool->threadCount && !stolen; i++)
+        {
+            stolen = stealTask(&pool->deques[(worker->id + i) % pool->threadCount], &task);
+        }
+        if (!stolen)
+        {
+            break;
+        }
+        runSweepTask(pool, task);
+    }
+    return NULL;
+}
@@ -0,0 +1,52 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "scheduler.h"
+
+/*
+Parameter sweep: runs one independent simulation per (trace, configuration) pair across a pool of threads.
+A configuration is a policy, time quantum, context switch cost and CPU count.
+Each worker owns a deque of simulations, takes work from its own end and steals from the other end of
+another worker's deque once it runs dry.
+
+Traces are parsed once by the caller and shared read-only between the simulations, the sweep indexes each one
+by arrival time once (only if it is not in arrival order already). A simulation streams the processes of its
+trace in that order: a process is copied into the simulation when it is about to arrive and its row is reused
+once it completes, so a simulation only holds the processes in flight. Memory for many configurations over one
+long trace stays close to a single copy of the trace.
+*/
+
+typedef struct sweepTrace
+{
+    const char *name;
+    const int *arrivalTime;
+    const int *burstTime;
+    const int *priority; // NULL when every process is in priority class 0
+    const int *group;    // NULL when every process is in group 0
+    int groupCount;      // highest group + 1
+    int count;
+} sweepTrace;
+
+typedef struct sweepConfig
+{
+    schedulerPolicy policy;
+    int timeQuantum;
+    int switchCost;
+    int cpuCount;
+} sweepConfig;
+
+typedef struct sweepResult
+{
+    int trace;       // index into the traces of the sweep
+    int config;      // index into the configurations of the sweep
+    int timeQuantum;
+    schedulerStatus status;
+    schedulerResults results;
+} sweepResult;
+
+int SweepDefaultThreadCount(void);
+void SweepDefaultConfig(sweepConfig *config);
+schedulerStatus RunSweep(const sweepTrace *traces, int traceCount, const int *timeQuanta, int quantumCount, int threadCount, sweepResult *results);
+schedulerStatus RunSweepConfigs(const sweepTrace *traces, int traceCount, const sweepConfig *configs, int configCount, int threadCount, sweepResult *results);
+
+#endif
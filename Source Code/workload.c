@@ -0,0 +1,110 @@
+#include <string.h>
+#include <math.h>
+#include "workload.h"
+
+#define PARETO_SHAPE 1.5 // finite mean, infinite variance
+
+static const char *workloadKindNames[WORKLOAD_KIND_COUNT] = {"uniform", "poisson", "bimodal", "pareto", "bursty"};
+
+static unsigned long long nextRandom(unsigned long long *state);
+static double uniformRandom(unsigned long long *state);
+static double exponentialRandom(unsigned long long *state, double mean);
+static int uniformBurst(unsigned long long *state, int lowest, int highest);
+static int generateBurst(workloadKind kind, unsigned long long *state);
+
+const char *WorkloadKindName(workloadKind kind)
+{
+    return kind >= 0 && kind < WORKLOAD_KIND_COUNT ? workloadKindNames[kind] : "unknown";
+}
+
+int ParseWorkloadKind(const char *name)
+{
+    // Returns -1 for an unknown name
+    for (int kind = 0; kind < WORKLOAD_KIND_COUNT; kind++)
+    {
+        if (strcmp(name, workloadKindNames[kind]) == 0)
+        {
+            return kind;
+        }
+    }
+    return -1;
+}
+
+void GenerateWorkload(workloadKind kind, int count, unsigned long long seed, int *arrivalTime, int *burstTime)
+{
+    // Fills count rows of both columns in arrival order
+    // The clock is kept as a double and truncated per process, so rounding does not drift the offered load
+    unsigned long long state = seed;
+    double meanGap = WORKLOAD_MEAN_BURST / WORKLOAD_LOAD;
+    double clock = 0.0;
+    int batchLeft = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (kind == WORKLOAD_UNIFORM)
+        {
+            clock += uniformRandom(&state) * 2.0 * meanGap;
+        }
+        else if (kind == WORKLOAD_BURSTY)
+        {
+            // Geometric batch sizes, exponential gaps between batches, same mean load as the others
+            if (batchLeft == 0)
+            {
+                clock += exponentialRandom(&state, meanGap * WORKLOAD_BATCH_SIZE);
+                batchLeft = 1 + (int)exponentialRandom(&state, WORKLOAD_BATCH_SIZE - 1);
+            }
+            batchLeft--;
+        }
+        else
+        {
+            clock += exponentialRandom(&state, meanGap);
+        }
+        arrivalTime[i] = (int)clock;
+        burstTime[i] = generateBurst(kind, &state);
+    }
+}
+
+static int generateBurst(workloadKind kind, unsigned long long *state)
+{
+    if (kind == WORKLOAD_BIMODAL)
+    {
+        // 90% interactive bursts of 1-5, 10% batch bursts of 50-90
+        if (uniformRandom(state) < 0.9)
+        {
+            return uniformBurst(state, 1, 5);
+        }
+        return uniformBurst(state, 50, 90);
+    }
+    if (kind == WORKLOAD_PARETO)
+    {
+        // Inverse transform, scale chosen so the (uncut) mean is WORKLOAD_MEAN_BURST
+        double scale = WORKLOAD_MEAN_BURST * (PARETO_SHAPE - 1.0) / PARETO_SHAPE;
+        double burst = ceil(scale / pow(1.0 - uniformRandom(state), 1.0 / PARETO_SHAPE));
+        return burst < WORKLOAD_MAX_BURST ? (int)burst : WORKLOAD_MAX_BURST;
+    }
+    return uniformBurst(state, 1, 2 * WORKLOAD_MEAN_BURST - 1);
+}
+
+static unsigned long long nextRandom(unsigned long long *state)
+{
+    // splitmix64, the full 64 bit state is advanced by a constant so every seed is usable
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double uniformRandom(unsigned long long *state)
+{
+    // [0, 1) with 53 random bits
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double exponentialRandom(unsigned long long *state, double mean)
+{
+    return -mean * log(1.0 - uniformRandom(state));
+}
+
+static int uniformBurst(unsigned long long *state, int lowest, int highest)
+{
+    return lowest + (int)(uniformRandom(state) * (highest - lowest + 1));
+}
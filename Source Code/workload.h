@@ -0,0 +1,28 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+/*
+Seeded synthetic workloads: arrival and burst time columns of any size, the same for the same seed on every host.
+Bursts average about WORKLOAD_MEAN_BURST and arrivals are spaced so one CPU is offered WORKLOAD_LOAD of its time.
+*/
+
+#define WORKLOAD_MEAN_BURST 10
+#define WORKLOAD_LOAD 0.9
+#define WORKLOAD_MAX_BURST 1000000 // Pareto bursts are cut off here so completion times stay within an int
+#define WORKLOAD_BATCH_SIZE 20     // mean processes arriving together in a bursty workload
+
+typedef enum workloadKind
+{
+    WORKLOAD_UNIFORM = 0, // uniform gaps between arrivals, uniform bursts
+    WORKLOAD_POISSON,     // exponential gaps between arrivals (Poisson arrivals), uniform bursts
+    WORKLOAD_BIMODAL,     // Poisson arrivals, mostly short bursts and a few long ones
+    WORKLOAD_PARETO,      // Poisson arrivals, heavy tailed Pareto bursts
+    WORKLOAD_BURSTY,      // batches of processes arrive at once with long gaps between them, uniform bursts
+    WORKLOAD_KIND_COUNT
+} workloadKind;
+
+const char *WorkloadKindName(workloadKind kind);
+int ParseWorkloadKind(const char *name);
+void GenerateWorkload(workloadKind kind, int count, unsigned long long seed, int *arrivalTime, int *burstTime);
+
+#endif